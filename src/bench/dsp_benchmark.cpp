@@ -0,0 +1,1015 @@
+/**
+ * @file dsp_benchmark.cpp
+ * @brief Per-module DSP micro-benchmarks with JSON output
+ *
+ * Renders every core module under a light and a worst-case setting and
+ * reports ns/sample and samples/second. The JSON report is meant to be
+ * diffed between commits to catch regressions and prove optimizations.
+ *
+ * Usage:
+ *   dsp_benchmark [--rate HZ] [--samples N] [--reps N] [--filter TEXT]
+ *                 [--out FILE]
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "core/envelope.hpp"
+#include "core/filter.hpp"
+#include "core/filter_bank.hpp"
+#include "core/lfo.hpp"
+#include "core/noise.hpp"
+#include "core/oscillator.hpp"
+#include "core/phase_acc_oscillator.hpp"
+#include "core/saturator.hpp"
+#include "core/unison.hpp"
+#include "effects/chorus.hpp"
+#include "effects/delay.hpp"
+#include "effects/reverb.hpp"
+#include "engine/simd_synth_engine.hpp"
+#include "engine/synth_engine.hpp"
+#include "io/wavetable_file.hpp"
+
+using namespace synth;
+
+namespace {
+
+// Renders numSamples into a mono buffer; set up once per measurement
+using RenderFn = std::function<void(Sample *out, int numSamples)>;
+using SetupFn = std::function<RenderFn(double sampleRate)>;
+
+struct BenchCase {
+  std::string module;
+  std::string variant;
+  SetupFn setup;
+};
+
+struct BenchResult {
+  std::string module;
+  std::string variant;
+  double nsPerSample;
+  double samplesPerSecond;
+};
+
+struct Options {
+  double sampleRate = DEFAULT_SAMPLE_RATE;
+  int samples = 192000;
+  int reps = 5;
+  std::string filter;
+  std::string outPath;
+};
+
+constexpr int CHUNK = MAX_BLOCK_SIZE;
+
+volatile double g_sink = 0.0; // Keeps rendered output observable
+
+/**
+ * @brief Time one case: best of several runs of opts.samples samples
+ */
+BenchResult runCase(const BenchCase &c, const Options &opts) {
+  std::vector<Sample> buf(CHUNK);
+  double best = 1e30;
+
+  for (int rep = 0; rep < opts.reps + 1; ++rep) {
+    RenderFn render = c.setup(opts.sampleRate);
+    double sum = 0.0;
+
+    auto start = std::chrono::steady_clock::now();
+    for (int done = 0; done < opts.samples; done += CHUNK) {
+      int n = std::min(CHUNK, opts.samples - done);
+      render(buf.data(), n);
+      sum += buf[0] + buf[n - 1];
+    }
+    double seconds = std::chrono::duration<double>(
+                         std::chrono::steady_clock::now() - start)
+                         .count();
+    g_sink = g_sink + sum;
+
+    if (rep > 0) // First run is warm-up
+      best = std::min(best, seconds);
+  }
+
+  BenchResult r;
+  r.module = c.module;
+  r.variant = c.variant;
+  r.nsPerSample = best * 1e9 / opts.samples;
+  r.samplesPerSecond = opts.samples / best;
+  return r;
+}
+
+// ==================== Case Builders ====================
+
+std::string mixName(int mask) {
+  static const char *names[] = {"sine", "tri", "saw", "square", "noise"};
+  std::string s;
+  for (int b = 0; b < 5; ++b) {
+    if (mask & (1 << b)) {
+      if (!s.empty())
+        s += "+";
+      s += names[b];
+    }
+  }
+  return s;
+}
+
+void addOscillatorCases(std::vector<BenchCase> &cases) {
+  const struct {
+    Waveform wf;
+    const char *name;
+  } waves[] = {{Waveform::SINE, "sine"},
+               {Waveform::TRIANGLE, "tri"},
+               {Waveform::SAW, "saw"},
+               {Waveform::SQUARE, "square"},
+               {Waveform::NOISE, "noise"}};
+
+  for (const auto &w : waves) {
+    for (int worst = 0; worst < 2; ++worst) {
+      Waveform wf = w.wf;
+      Frequency freq = worst ? 8000.0 : 110.0;
+      cases.push_back(
+          {"Oscillator", std::string(w.name) + (worst ? "/8kHz" : "/110Hz"),
+           [wf, freq](double sr) -> RenderFn {
+             auto osc = std::make_shared<Oscillator>();
+             osc->prepare(sr);
+             osc->setWaveform(wf);
+             osc->setFrequency(freq);
+             return [osc](Sample *out, int n) { osc->processBlock(out, n); };
+           }});
+    }
+  }
+
+  for (const auto &w : waves) {
+    for (int worst = 0; worst < 2; ++worst) {
+      Waveform wf = w.wf;
+      Frequency freq = worst ? 8000.0 : 110.0;
+      cases.push_back(
+          {"PhaseAccOscillator",
+           std::string(w.name) + (worst ? "/8kHz" : "/110Hz"),
+           [wf, freq](double sr) -> RenderFn {
+             auto osc = std::make_shared<PhaseAccOscillator>();
+             osc->prepare(sr);
+             osc->setWaveform(wf);
+             osc->setFrequency(freq);
+             return [osc](Sample *out, int n) { osc->processBlock(out, n); };
+           }});
+    }
+  }
+
+  for (const auto &w : waves) {
+    if (w.wf == Waveform::NOISE)
+      continue;
+    for (int cubic = 0; cubic < 2; ++cubic) {
+      Waveform wf = w.wf;
+      cases.push_back(
+          {"WavetableOscillator",
+           std::string(w.name) + (cubic ? "/8kHz/cubic" : "/8kHz/linear"),
+           [wf, cubic](double sr) -> RenderFn {
+             auto osc = std::make_shared<WavetableOscillator>();
+             osc->prepare(sr);
+             osc->setWaveform(wf);
+             osc->setFrequency(8000.0);
+             osc->setInterpolation(
+                 cubic ? WavetableOscillator::Interpolation::CUBIC
+                       : WavetableOscillator::Interpolation::LINEAR);
+             return [osc](Sample *out, int n) { osc->processBlock(out, n); };
+           }});
+    }
+  }
+
+  // Saw stacks: compare against N times the Oscillator saw case
+  for (int voices : {1, 4, 8, 16}) {
+    cases.push_back(
+        {"UnisonOscillator", std::to_string(voices) + "-saws/stereo",
+         [voices](double sr) -> RenderFn {
+           auto osc = std::make_shared<UnisonOscillator>();
+           osc->prepare(sr);
+           osc->setVoices(voices);
+           osc->setDetune(0.5);
+           osc->setSpread(1.0);
+           osc->setFrequency(110.0);
+           osc->noteOn();
+           auto right = std::make_shared<std::vector<Sample>>(CHUNK);
+           return [osc, right](Sample *out, int n) {
+             osc->processBlock(out, right->data(), n);
+           };
+         }});
+  }
+
+  cases.push_back(
+      {"NoiseGenerator", "block", [](double) -> RenderFn {
+         auto noise = std::make_shared<NoiseGenerator>(1u);
+         return [noise](Sample *out, int n) { noise->processBlock(out, n); };
+       }});
+
+  // Every non-empty waveform combination of the mixing oscillator
+  for (int mask = 1; mask < 32; ++mask) {
+    for (int worst = 0; worst < 2; ++worst) {
+      Frequency freq = worst ? 8000.0 : 110.0;
+      cases.push_back(
+          {"MixingOscillator", mixName(mask) + (worst ? "/8kHz" : "/110Hz"),
+           [mask, freq](double sr) -> RenderFn {
+             auto osc = std::make_shared<MixingOscillator>();
+             osc->prepare(sr);
+             osc->setMix((mask & 1) ? 1.0 : 0.0, (mask & 2) ? 1.0 : 0.0,
+                         (mask & 4) ? 1.0 : 0.0, (mask & 8) ? 1.0 : 0.0,
+                         (mask & 16) ? 1.0 : 0.0);
+             osc->setFrequency(freq);
+             return [osc](Sample *out, int n) { osc->processBlock(out, n); };
+           }});
+    }
+  }
+
+  // VCO2 as a slave of VCO1: band-limited hard sync, plus cross mod
+  for (int cross = 0; cross < 2; ++cross) {
+    cases.push_back(
+        {"MixingOscillator", cross ? "saw/sync+cross" : "saw/sync",
+         [cross](double sr) -> RenderFn {
+           auto master = std::make_shared<MixingOscillator>();
+           auto slave = std::make_shared<MixingOscillator>();
+           auto buf = std::make_shared<std::vector<Sample>>(CHUNK);
+           master->prepare(sr);
+           slave->prepare(sr);
+           master->setFrequency(220.0);
+           slave->setFrequency(220.0 * 3.3);
+           return [master, slave, buf, cross](Sample *out, int n) {
+             OscModulation mod;
+             mod.sync = true;
+             mod.masterPhase = master->getPhase();
+             mod.masterIncrement = master->getPhaseIncrement();
+             master->processBlock(buf->data(), n);
+             if (cross) {
+               mod.cross = buf->data();
+               mod.crossDepth = 0.3;
+             }
+             slave->processBlock(out, n, mod);
+           };
+         }});
+  }
+
+  const struct {
+    MultiEngine::Mode mode;
+    const char *name;
+  } modes[] = {{MultiEngine::Mode::VPM, "vpm"},
+               {MultiEngine::Mode::WAVES, "waves"},
+               {MultiEngine::Mode::NOISE, "noise"}};
+
+  for (const auto &m : modes) {
+    for (int worst = 0; worst < 2; ++worst) {
+      MultiEngine::Mode mode = m.mode;
+      cases.push_back({"MultiEngine", std::string(m.name) +
+                                          (worst ? "/deep" : "/light"),
+                       [mode, worst](double sr) -> RenderFn {
+                         auto me = std::make_shared<MultiEngine>();
+                         me->prepare(sr);
+                         me->setMode(mode);
+                         me->setFrequency(worst ? 4000.0 : 110.0);
+                         me->setModIndex(worst ? 1.0 : 0.1);
+                         me->setRatio(worst ? 1.0 : 0.0);
+                         me->setShape(0.5);
+                         me->noteOn();
+                         return [me](Sample *out, int n) {
+                           me->processBlock(out, n);
+                         };
+                       }});
+    }
+  }
+
+  // WAVES over a user bank: 64 frames, saw fading into square
+  auto bank = std::make_shared<WavetableWriter>(64);
+  {
+    std::vector<std::vector<double>> frames(
+        64, std::vector<double>(WAVETABLE_SIZE));
+    for (int f = 0; f < 64; ++f)
+      for (int n = 0; n < WAVETABLE_SIZE; ++n) {
+        double p = static_cast<double>(n) / WAVETABLE_SIZE;
+        double saw = 2.0 * p - 1.0, square = p < 0.5 ? 1.0 : -1.0;
+        frames[f][n] = saw + (square - saw) * f / 63.0;
+      }
+    bank->addTable(frames);
+  }
+  for (int worst = 0; worst < 2; ++worst) {
+    cases.push_back({"MultiEngine", std::string("waves-bank") +
+                                        (worst ? "/deep" : "/light"),
+                     [bank, worst](double sr) -> RenderFn {
+                       auto set = std::make_shared<WavetableSet>(bank->view());
+                       auto me = std::make_shared<MultiEngine>();
+                       me->prepare(sr);
+                       me->setMode(MultiEngine::Mode::WAVES);
+                       me->setWavetables(set.get());
+                       me->setFrequency(worst ? 4000.0 : 110.0);
+                       me->setShape(0.37);
+                       return [me, set](Sample *out, int n) {
+                         me->processBlock(out, n);
+                       };
+                     }});
+  }
+
+  // ADDITIVE: 1/k harmonic series, all below Nyquist at 55 Hz / 48 kHz
+  for (int partials : {16, 64, 256}) {
+    cases.push_back({"MultiEngine", "additive/" + std::to_string(partials),
+                     [partials](double sr) -> RenderFn {
+                       AdditivePatch patch;
+                       for (int k = 1; k <= partials; ++k)
+                         patch.add(static_cast<float>(k), 1.0f / k);
+                       auto me = std::make_shared<MultiEngine>();
+                       me->prepare(sr);
+                       me->setMode(MultiEngine::Mode::ADDITIVE);
+                       me->setAdditivePatch(patch);
+                       me->setFrequency(55.0);
+                       me->noteOn();
+                       return [me](Sample *out, int n) {
+                         me->processBlock(out, n);
+                       };
+                     }});
+  }
+
+  for (int alg = 0; alg < FM_NUM_ALGORITHMS; ++alg) {
+    cases.push_back(
+        {"FmEngine", "alg" + std::to_string(alg + 1) + "/4op",
+         [alg](double sr) -> RenderFn {
+           auto fm = std::make_shared<FmEngine>();
+           fm->prepare(sr);
+           FmPatch patch;
+           patch.algorithm = alg;
+           patch.feedback = 0.5;
+           for (int k = 0; k < FM_OPERATORS; ++k) {
+             patch.op[k].ratio = 1.0 + k;
+             patch.op[k].level = 0.5;
+           }
+           fm->setPatch(patch);
+           fm->setFrequency(440.0);
+           fm->noteOn();
+           return [fm](Sample *out, int n) { fm->processBlock(out, n); };
+         }});
+  }
+}
+
+template <typename Saturator>
+void addLadderTierCase(std::vector<BenchCase> &cases,
+                       const std::string &variant) {
+  cases.push_back(
+      {"LadderFilter", variant, [](double sr) -> RenderFn {
+         auto f = std::make_shared<BasicLadderFilter<Saturator>>();
+         auto src = std::make_shared<MixingOscillator>();
+         f->setOversampling(1);
+         f->prepare(sr);
+         src->prepare(sr);
+         src->setFrequency(220.0);
+         f->setCutoff(2000.0);
+         f->setResonance(0.9);
+         return [f, src](Sample *out, int n) {
+           src->processBlock(out, n);
+           f->processBlock(out, n);
+         };
+       }});
+}
+
+void addFilterCases(std::vector<BenchCase> &cases) {
+  // Light: static cutoff, clean. Worst: drive plus per-sample cutoff sweep
+  for (int worst = 0; worst < 2; ++worst) {
+    cases.push_back(
+        {"StateVariableFilter", worst ? "drive/audio-rate-cutoff" : "static",
+         [worst](double sr) -> RenderFn {
+           auto f = std::make_shared<StateVariableFilter>();
+           auto src = std::make_shared<MixingOscillator>();
+           f->prepare(sr);
+           src->prepare(sr);
+           src->setFrequency(220.0);
+           f->setCutoff(2000.0);
+           f->setResonance(worst ? 0.9 : 0.3);
+           f->setDrive(worst ? 1.0 : 0.0);
+           auto phase = std::make_shared<double>(0.0);
+           return [f, src, phase, worst](Sample *out, int n) {
+             src->processBlock(out, n);
+             if (!worst) {
+               f->processBlock(out, n);
+               return;
+             }
+             for (int i = 0; i < n; ++i) {
+               *phase += 1e-4;
+               f->setCutoff(2000.0 + 1500.0 * std::sin(*phase));
+               out[i] = f->process(out[i]);
+             }
+           };
+         }});
+  }
+
+  // The worst case again with the cutoff modulated in octaves, as Voice
+  // does: no Hz -> pitch conversion before the table lookup
+  cases.push_back(
+      {"StateVariableFilter", "drive/audio-rate-pitch",
+       [](double sr) -> RenderFn {
+         auto f = std::make_shared<StateVariableFilter>();
+         auto src = std::make_shared<MixingOscillator>();
+         f->prepare(sr);
+         src->prepare(sr);
+         src->setFrequency(220.0);
+         f->setResonance(0.9);
+         f->setDrive(1.0);
+         auto phase = std::make_shared<double>(0.0);
+         const double pitch = cutoffToPitch(2000.0);
+         return [f, src, phase, pitch](Sample *out, int n) {
+           src->processBlock(out, n);
+           for (int i = 0; i < n; ++i) {
+             *phase += 1e-4;
+             f->setCutoffPitch(pitch + std::sin(*phase));
+             out[i] = f->process(out[i]);
+           }
+         };
+       }});
+
+  // Same settings for the TPT form; worst passes a per-sample cutoff
+  for (int worst = 0; worst < 2; ++worst) {
+    cases.push_back(
+        {"ZdfFilter", worst ? "drive/audio-rate-cutoff" : "static",
+         [worst](double sr) -> RenderFn {
+           auto f = std::make_shared<ZdfFilter>();
+           auto src = std::make_shared<MixingOscillator>();
+           f->prepare(sr);
+           src->prepare(sr);
+           src->setFrequency(220.0);
+           f->setCutoff(2000.0);
+           f->setResonance(worst ? 0.9 : 0.3);
+           f->setDrive(worst ? 1.0 : 0.0);
+           auto phase = std::make_shared<double>(0.0);
+           auto cutoff = std::make_shared<std::vector<Sample>>();
+           return [f, src, phase, cutoff, worst](Sample *out, int n) {
+             src->processBlock(out, n);
+             if (!worst) {
+               f->processBlock(out, n);
+               return;
+             }
+             cutoff->resize(n);
+             for (int i = 0; i < n; ++i) {
+               *phase += 1e-4;
+               (*cutoff)[i] = 2000.0 + 1500.0 * std::sin(*phase);
+             }
+             f->processBlock(out, cutoff->data(), n);
+           };
+         }});
+  }
+
+  for (int worst = 0; worst < 2; ++worst) {
+    cases.push_back(
+        {"LadderFilter", worst ? "resonant/audio-rate-cutoff" : "static",
+         [worst](double sr) -> RenderFn {
+           auto f = std::make_shared<LadderFilter>();
+           auto src = std::make_shared<MixingOscillator>();
+           f->prepare(sr);
+           src->prepare(sr);
+           src->setFrequency(220.0);
+           f->setCutoff(2000.0);
+           f->setResonance(worst ? 1.0 : 0.3);
+           auto phase = std::make_shared<double>(0.0);
+           return [f, src, phase, worst](Sample *out, int n) {
+             src->processBlock(out, n);
+             for (int i = 0; i < n; ++i) {
+               if (worst) {
+                 *phase += 1e-4;
+                 f->setCutoff(2000.0 + 1500.0 * std::sin(*phase));
+               }
+               out[i] = f->process(out[i]);
+             }
+           };
+         }});
+  }
+
+  // Cost of oversampling the saturating stages, block path
+  for (int factor : {1, 2, 4}) {
+    const std::string variant = "block/" + std::to_string(factor) + "x";
+    cases.push_back(
+        {"StateVariableFilter", "drive-" + variant,
+         [factor](double sr) -> RenderFn {
+           auto f = std::make_shared<StateVariableFilter>();
+           auto src = std::make_shared<MixingOscillator>();
+           f->setOversampling(factor);
+           f->prepare(sr);
+           src->prepare(sr);
+           src->setFrequency(220.0);
+           f->setCutoff(2000.0);
+           f->setResonance(0.9);
+           f->setDrive(1.0);
+           return [f, src](Sample *out, int n) {
+             src->processBlock(out, n);
+             f->processBlock(out, n);
+           };
+         }});
+    cases.push_back(
+        {"ZdfFilter", "drive-" + variant, [factor](double sr) -> RenderFn {
+           auto f = std::make_shared<ZdfFilter>();
+           auto src = std::make_shared<MixingOscillator>();
+           f->setOversampling(factor);
+           f->prepare(sr);
+           src->prepare(sr);
+           src->setFrequency(220.0);
+           f->setCutoff(2000.0);
+           f->setResonance(0.9);
+           f->setDrive(1.0);
+           return [f, src](Sample *out, int n) {
+             src->processBlock(out, n);
+             f->processBlock(out, n);
+           };
+         }});
+    cases.push_back(
+        {"LadderFilter", variant, [factor](double sr) -> RenderFn {
+           auto f = std::make_shared<LadderFilter>();
+           auto src = std::make_shared<MixingOscillator>();
+           f->setOversampling(factor);
+           f->prepare(sr);
+           src->prepare(sr);
+           src->setFrequency(220.0);
+           f->setCutoff(2000.0);
+           f->setResonance(0.9);
+           return [f, src](Sample *out, int n) {
+             src->processBlock(out, n);
+             f->processBlock(out, n);
+           };
+         }});
+  }
+
+  // The ladder's cost by saturator tier (block/1x above is TanhPade)
+  addLadderTierCase<TanhExact>(cases, "tier/exact");
+  addLadderTierCase<TanhTable>(cases, "tier/table");
+  addLadderTierCase<TanhPolynomial>(cases, "tier/polynomial");
+}
+
+/**
+ * @brief Eight voices' filters per output sample: FilterBank against
+ *        eight scalar filters with the same settings, both at 1x with a
+ *        cutoff ramp per control block
+ */
+void addFilterBankCases(std::vector<BenchCase> &cases) {
+  constexpr int VOICES = 8;
+  using Bank = FilterBank<VOICES>;
+
+  for (FilterType type : {FilterType::SVF, FilterType::LADDER}) {
+    const bool ladder = type == FilterType::LADDER;
+    cases.push_back(
+        {"FilterBank", ladder ? "ladder/8-voices" : "svf/8-voices",
+         [type](double sr) -> RenderFn {
+           auto bank = std::make_shared<Bank>();
+           auto src = std::make_shared<MixingOscillator>();
+           auto buf = std::make_shared<std::vector<Float4>>(
+               CONTROL_BLOCK_SIZE * Bank::GROUPS);
+           bank->prepare(sr);
+           bank->setType(type);
+           bank->setResonance(0.9);
+           bank->setDrive(0.6);
+           src->prepare(sr);
+           src->setFrequency(220.0);
+           return [bank, src, buf](Sample *out, int n) {
+             src->processBlock(out, n);
+             double pitch[VOICES];
+             for (int v = 0; v < VOICES; ++v)
+               pitch[v] = cutoffToPitch(500.0 * (v + 1));
+             for (int offset = 0; offset < n; offset += CONTROL_BLOCK_SIZE) {
+               const int len = std::min(CONTROL_BLOCK_SIZE, n - offset);
+               Float4 *b = buf->data();
+               for (int i = 0; i < len; ++i) {
+                 const float x = static_cast<float>(out[offset + i]);
+                 for (int g = 0; g < Bank::GROUPS; ++g)
+                   b[i * Bank::GROUPS + g] = x;
+               }
+               bank->rampCutoffPitch(pitch, len);
+               bank->processBlock(b, len);
+               alignas(16) float lanes[SIMD_WIDTH];
+               for (int i = 0; i < len; ++i) {
+                 b[i * Bank::GROUPS].store(lanes);
+                 out[offset + i] = lanes[0];
+               }
+             }
+           };
+         }});
+  }
+
+  // The same work one voice at a time
+  auto scalar = [](auto filters) {
+    return [filters](double sr) -> RenderFn {
+      auto src = std::make_shared<MixingOscillator>();
+      auto voice = std::make_shared<std::vector<Sample>>(CHUNK);
+      for (auto &f : *filters) {
+        f.setOversampling(1);
+        f.prepare(sr);
+        f.setResonance(0.9);
+        f.setDrive(0.6);
+      }
+      src->prepare(sr);
+      src->setFrequency(220.0);
+      return [filters, src, voice](Sample *out, int n) {
+        src->processBlock(out, n);
+        for (int v = 0; v < VOICES; ++v) {
+          auto &f = (*filters)[v];
+          const double pitch = cutoffToPitch(500.0 * (v + 1));
+          Sample *x = voice->data();
+          std::copy(out, out + n, x);
+          for (int offset = 0; offset < n; offset += CONTROL_BLOCK_SIZE) {
+            const int len = std::min(CONTROL_BLOCK_SIZE, n - offset);
+            f.rampCutoffPitch(pitch, len);
+            f.processBlock(x + offset, len);
+          }
+        }
+        std::copy(voice->data(), voice->data() + n, out);
+      };
+    };
+  };
+  cases.push_back(
+      {"StateVariableFilter", "8-voices/1x",
+       scalar(std::make_shared<std::vector<StateVariableFilter>>(VOICES))});
+  cases.push_back(
+      {"LadderFilter", "8-voices/1x",
+       scalar(std::make_shared<std::vector<LadderFilter>>(VOICES))});
+}
+
+// Drive of 4 on a saw, so most samples land in the curved region.
+// scalar: one double per call, as inside a filter loop; block: the
+// Float4 saturateBlock()
+template <typename Saturator>
+void addSaturatorTierCases(std::vector<BenchCase> &cases,
+                           const std::string &tier) {
+  for (int block = 0; block < 2; ++block) {
+    cases.push_back(
+        {"Saturator", tier + (block ? "/block" : "/scalar"),
+         [block](double sr) -> RenderFn {
+           auto src = std::make_shared<MixingOscillator>();
+           src->prepare(sr);
+           src->setFrequency(220.0);
+           return [src, block](Sample *out, int n) {
+             src->processBlock(out, n);
+             if (block) {
+               saturateBlock<Saturator>(out, n, 4.0);
+               return;
+             }
+             for (int i = 0; i < n; ++i)
+               out[i] = Saturator::process(out[i] * 4.0);
+           };
+         }});
+  }
+}
+
+void addSaturatorCases(std::vector<BenchCase> &cases) {
+  // The saw alone, to subtract from the tier cases
+  cases.push_back({"Saturator", "none", [](double sr) -> RenderFn {
+                     auto src = std::make_shared<MixingOscillator>();
+                     src->prepare(sr);
+                     src->setFrequency(220.0);
+                     return [src](Sample *out, int n) {
+                       src->processBlock(out, n);
+                     };
+                   }});
+  addSaturatorTierCases<TanhExact>(cases, "exact");
+  addSaturatorTierCases<TanhTable>(cases, "table");
+  addSaturatorTierCases<TanhPade>(cases, "pade");
+  addSaturatorTierCases<TanhPolynomial>(cases, "polynomial");
+  addSaturatorTierCases<RationalClip>(cases, "rational");
+}
+
+void addModulationCases(std::vector<BenchCase> &cases) {
+  // Light: holding sustain. Worst: 1 ms stages retriggered continuously
+  for (int worst = 0; worst < 2; ++worst) {
+    cases.push_back({"ADSR", worst ? "retrigger-1ms" : "sustain",
+                     [worst](double sr) -> RenderFn {
+                       auto env = std::make_shared<ADSR>();
+                       env->prepare(sr);
+                       double t = worst ? 0.001 : 0.01;
+                       env->setAttack(t);
+                       env->setDecay(t);
+                       env->setSustain(0.5);
+                       env->setRelease(t);
+                       env->noteOn();
+                       auto count = std::make_shared<int>(0);
+                       return [env, count, worst](Sample *out, int n) {
+                         if (worst && (++*count % 4) == 0)
+                           env->noteOn();
+                         else if (worst && (*count % 4) == 2)
+                           env->noteOff();
+                         env->processBlock(out, n);
+                       };
+                     }});
+  }
+
+  const struct {
+    LFO::Shape shape;
+    const char *name;
+  } shapes[] = {{LFO::Shape::TRIANGLE, "triangle"},
+                {LFO::Shape::SINE, "sine"},
+                {LFO::Shape::SAMPLE_HOLD, "sample-hold"}};
+
+  for (const auto &s : shapes) {
+    LFO::Shape shape = s.shape;
+    bool worst = shape != LFO::Shape::TRIANGLE;
+    cases.push_back({"LFO", std::string(s.name) + (worst ? "/100Hz" : "/1Hz"),
+                     [shape, worst](double sr) -> RenderFn {
+                       auto lfo = std::make_shared<LFO>();
+                       lfo->prepare(sr);
+                       lfo->setShape(shape);
+                       lfo->setRate(worst ? 100.0 : 1.0);
+                       return [lfo](Sample *out, int n) {
+                         lfo->processBlock(out, n);
+                       };
+                     }});
+  }
+}
+
+/**
+ * @brief Wrap a stereo in-place effect with a saw source
+ */
+template <typename Effect, typename Configure>
+RenderFn makeEffectRender(double sr, Configure configure) {
+  auto fx = std::make_shared<Effect>();
+  auto src = std::make_shared<MixingOscillator>();
+  fx->prepare(sr);
+  src->prepare(sr);
+  src->setFrequency(220.0);
+  configure(*fx);
+  auto right = std::make_shared<std::vector<Sample>>(CHUNK);
+  return [fx, src, right](Sample *out, int n) {
+    src->processBlock(out, n);
+    std::copy(out, out + n, right->begin());
+    fx->processBlock(out, right->data(), n);
+  };
+}
+
+void addEffectCases(std::vector<BenchCase> &cases) {
+  for (int worst = 0; worst < 2; ++worst) {
+    cases.push_back({"Chorus", worst ? "deep/fast" : "default",
+                     [worst](double sr) {
+                       return makeEffectRender<Chorus>(sr, [worst](Chorus &c) {
+                         c.setRate(worst ? 5.0 : 0.5);
+                         c.setDepth(worst ? 1.0 : 0.5);
+                         c.setMix(0.5);
+                       });
+                     }});
+    cases.push_back({"Delay", worst ? "2s/high-feedback" : "250ms",
+                     [worst](double sr) {
+                       return makeEffectRender<Delay>(sr, [worst](Delay &d) {
+                         d.setDelayTime(worst ? 2000.0 : 250.0);
+                         d.setFeedback(worst ? 0.95 : 0.4);
+                         d.setMix(0.5);
+                       });
+                     }});
+    cases.push_back({"Reverb", worst ? "long-decay" : "default",
+                     [worst](double sr) {
+                       return makeEffectRender<Reverb>(sr, [worst](Reverb &r) {
+                         r.setDecay(worst ? 0.99 : 0.5);
+                         r.setMix(0.3);
+                       });
+                     }});
+  }
+}
+
+/**
+ * @brief Full engine: light = one held sine voice, worst = every voice on
+ *        a saw/square patch with heavy drive and LFO
+ */
+template <typename Engine> void addEngineCases(std::vector<BenchCase> &cases,
+                                               const char *name) {
+  // FM Bell preset: VCOs off, every voice on the 4-operator multi engine
+  cases.push_back({name, "all-voices/fm", [](double sr) -> RenderFn {
+                     auto engine = std::make_shared<Engine>();
+                     engine->prepare(sr);
+                     engine->loadPreset(9);
+                     for (int v = 0; v < engine->getPolyphony(); ++v)
+                       engine->noteOn(48 + 7 * v, 0.8);
+                     auto left = std::make_shared<std::vector<float>>(CHUNK);
+                     auto right = std::make_shared<std::vector<float>>(CHUNK);
+                     return [engine, left, right](Sample *out, int n) {
+                       engine->processBlock(left->data(), right->data(),
+                                            static_cast<uint32_t>(n));
+                       for (int i = 0; i < n; ++i)
+                         out[i] = (*left)[i];
+                     };
+                   }});
+
+  for (int worst = 0; worst < 2; ++worst) {
+    cases.push_back(
+        {name, worst ? "all-voices/drive" : "1-voice/init",
+         [worst](double sr) -> RenderFn {
+           auto engine = std::make_shared<Engine>();
+           engine->prepare(sr);
+           engine->loadPreset(worst ? 2 : 0);
+           if (worst) {
+             engine->setFilterDrive(1.0);
+             engine->setFilterResonance(0.9);
+             engine->setLfoDepth(1.0);
+             engine->setLfoRate(20.0);
+           }
+           int voices = worst ? engine->getPolyphony() : 1;
+           for (int v = 0; v < voices; ++v)
+             engine->noteOn(48 + 7 * v, 0.8);
+           auto left = std::make_shared<std::vector<float>>(CHUNK);
+           auto right = std::make_shared<std::vector<float>>(CHUNK);
+           return [engine, left, right](Sample *out, int n) {
+             engine->processBlock(left->data(), right->data(),
+                                  static_cast<uint32_t>(n));
+             for (int i = 0; i < n; ++i)
+               out[i] = (*left)[i];
+           };
+         }});
+  }
+}
+
+/**
+ * @brief Strings preset: every voice an 8-saw stereo unison stack
+ */
+void addSupersawCase(std::vector<BenchCase> &cases) {
+  cases.push_back(
+      {"SynthEngine", "all-voices/supersaw", [](double sr) -> RenderFn {
+         auto engine = std::make_shared<SynthEngine>();
+         engine->prepare(sr);
+         engine->loadPreset(8);
+         for (int v = 0; v < engine->getPolyphony(); ++v)
+           engine->noteOn(48 + 7 * v, 0.8);
+         auto left = std::make_shared<std::vector<float>>(CHUNK);
+         auto right = std::make_shared<std::vector<float>>(CHUNK);
+         return [engine, left, right](Sample *out, int n) {
+           engine->processBlock(left->data(), right->data(),
+                                static_cast<uint32_t>(n));
+           for (int i = 0; i < n; ++i)
+             out[i] = (*left)[i];
+         };
+       }});
+}
+
+/**
+ * @brief Lead preset on every voice with each filter model
+ */
+void addFilterModelCases(std::vector<BenchCase> &cases) {
+  static const struct {
+    FilterType type;
+    const char *name;
+  } models[] = {{FilterType::SVF, "all-voices/svf"},
+                {FilterType::LADDER, "all-voices/ladder"},
+                {FilterType::ZDF, "all-voices/zdf"}};
+  for (const auto &model : models) {
+    const FilterType type = model.type;
+    cases.push_back({"SynthEngine", model.name, [type](double sr) -> RenderFn {
+                       auto engine = std::make_shared<SynthEngine>();
+                       engine->prepare(sr);
+                       engine->loadPreset(2);
+                       engine->setFilterType(type);
+                       for (int v = 0; v < engine->getPolyphony(); ++v)
+                         engine->noteOn(48 + 7 * v, 0.8);
+                       auto left = std::make_shared<std::vector<float>>(CHUNK);
+                       auto right =
+                           std::make_shared<std::vector<float>>(CHUNK);
+                       return [engine, left, right](Sample *out, int n) {
+                         engine->processBlock(left->data(), right->data(),
+                                              static_cast<uint32_t>(n));
+                         for (int i = 0; i < n; ++i)
+                           out[i] = (*left)[i];
+                       };
+                     }});
+  }
+}
+
+/**
+ * @brief Full voice load through the enabled effects bus
+ */
+void addEffectsBusCase(std::vector<BenchCase> &cases) {
+  cases.push_back(
+      {"SynthEngine", "all-voices/effects", [](double sr) -> RenderFn {
+         auto engine = std::make_shared<SynthEngine>();
+         engine->prepare(sr);
+         engine->loadPreset(2);
+         engine->setChorusEnabled(true);
+         engine->setDelayEnabled(true);
+         engine->setReverbEnabled(true);
+         for (int v = 0; v < engine->getPolyphony(); ++v)
+           engine->noteOn(48 + 7 * v, 0.8);
+         auto left = std::make_shared<std::vector<float>>(CHUNK);
+         auto right = std::make_shared<std::vector<float>>(CHUNK);
+         return [engine, left, right](Sample *out, int n) {
+           engine->processBlock(left->data(), right->data(),
+                                static_cast<uint32_t>(n));
+           for (int i = 0; i < n; ++i)
+             out[i] = (*left)[i];
+         };
+       }});
+}
+
+/**
+ * @brief Large pools: 64-voice pad with every voice sounding, and the
+ *        same pool with a single voice to show idle voices are free
+ */
+void addPolyphonyCases(std::vector<BenchCase> &cases) {
+  for (int full = 0; full < 2; ++full) {
+    cases.push_back(
+        {"SynthEngine",
+         full ? "64-voice-pool/64-active" : "64-voice-pool/1-active", [full](double sr) -> RenderFn {
+           auto engine = std::make_shared<SynthEngine>(MAX_POLYPHONY);
+           engine->prepare(sr);
+           engine->loadPreset(3);
+           int voices = full ? MAX_POLYPHONY : 1;
+           for (int v = 0; v < voices; ++v)
+             engine->noteOn(36 + v, 0.5);
+           auto left = std::make_shared<std::vector<float>>(CHUNK);
+           auto right = std::make_shared<std::vector<float>>(CHUNK);
+           return [engine, left, right](Sample *out, int n) {
+             engine->processBlock(left->data(), right->data(),
+                                  static_cast<uint32_t>(n));
+             for (int i = 0; i < n; ++i)
+               out[i] = (*left)[i];
+           };
+         }});
+  }
+}
+
+std::vector<BenchCase> allCases() {
+  std::vector<BenchCase> cases;
+  addOscillatorCases(cases);
+  addFilterCases(cases);
+  addFilterBankCases(cases);
+  addSaturatorCases(cases);
+  addModulationCases(cases);
+  addEffectCases(cases);
+  addEngineCases<SynthEngine>(cases, "SynthEngine");
+  addSupersawCase(cases);
+  addFilterModelCases(cases);
+  addEffectsBusCase(cases);
+  addPolyphonyCases(cases);
+  addEngineCases<SimdSynthEngine>(cases, "SimdSynthEngine");
+  return cases;
+}
+
+void writeJson(std::ostream &out, const Options &opts,
+               const std::vector<BenchResult> &results) {
+  out << "{\n";
+  out << "  \"sample_rate\": " << static_cast<long>(opts.sampleRate) << ",\n";
+  out << "  \"samples\": " << opts.samples << ",\n";
+  out << "  \"reps\": " << opts.reps << ",\n";
+  out << "  \"results\": [\n";
+  for (size_t i = 0; i < results.size(); ++i) {
+    const BenchResult &r = results[i];
+    out << "    {\"module\": \"" << r.module << "\", \"case\": \"" << r.variant
+        << "\", \"ns_per_sample\": " << std::fixed << std::setprecision(3)
+        << r.nsPerSample << ", \"samples_per_second\": " << std::setprecision(0)
+        << r.samplesPerSecond << "}" << (i + 1 < results.size() ? "," : "")
+        << "\n";
+  }
+  out << "  ]\n}\n";
+}
+
+void printUsage() {
+  std::cerr << "Usage: dsp_benchmark [--rate HZ] [--samples N] [--reps N]"
+               " [--filter TEXT] [--out FILE]\n";
+}
+
+} // namespace
+
+int main(int argc, char **argv) {
+  Options opts;
+  for (int i = 1; i + 1 < argc; i += 2) {
+    if (std::strcmp(argv[i], "--rate") == 0) {
+      opts.sampleRate = std::atof(argv[i + 1]);
+    } else if (std::strcmp(argv[i], "--samples") == 0) {
+      opts.samples = std::atoi(argv[i + 1]);
+    } else if (std::strcmp(argv[i], "--reps") == 0) {
+      opts.reps = std::atoi(argv[i + 1]);
+    } else if (std::strcmp(argv[i], "--filter") == 0) {
+      opts.filter = argv[i + 1];
+    } else if (std::strcmp(argv[i], "--out") == 0) {
+      opts.outPath = argv[i + 1];
+    } else {
+      printUsage();
+      return 1;
+    }
+  }
+  if ((argc - 1) % 2 != 0 || opts.sampleRate <= 0.0 || opts.samples <= 0 ||
+      opts.reps <= 0) {
+    printUsage();
+    return 1;
+  }
+
+  std::vector<BenchResult> results;
+  for (const BenchCase &c : allCases()) {
+    std::string id = c.module + "/" + c.variant;
+    if (!opts.filter.empty() && id.find(opts.filter) == std::string::npos)
+      continue;
+    results.push_back(runCase(c, opts));
+    std::cerr << std::left << std::setw(48) << id << std::right << std::fixed
+              << std::setprecision(2) << std::setw(10)
+              << results.back().nsPerSample << " ns/sample\n";
+  }
+
+  if (opts.outPath.empty()) {
+    writeJson(std::cout, opts, results);
+  } else {
+    std::ofstream file(opts.outPath);
+    if (!file) {
+      std::cerr << "Cannot write " << opts.outPath << "\n";
+      return 1;
+    }
+    writeJson(file, opts, results);
+  }
+  return 0;
+}
@@ -0,0 +1,289 @@
+#pragma once
+/**
+ * @file additive.hpp
+ * @brief Additive sine-partial engine (MultiEngine ADDITIVE mode)
+ *
+ * Up to ADDITIVE_MAX_PARTIALS sines per voice, each a recursive rotation
+ * oscillator: the complex state (re, im) is multiplied by e^(jw) every
+ * sample, so a partial costs four multiplies and no table or libm call.
+ * Partials are processed four at a time as Float4 lanes.
+ *
+ * Only audible partials are rendered. Those at or above Nyquist, or with
+ * zero level, are culled when the note starts, and partials that decay
+ * below ADDITIVE_SILENCE are dropped at control rate, so the cost follows
+ * the partials that can still be heard. Being pure sines, the partials
+ * never alias.
+ *
+ * On the FPGA this is one complex-multiply core time-multiplexed over the
+ * partial state RAM, with the rotation coefficients in a second RAM.
+ */
+
+#include "simd.hpp"
+#include "types.hpp"
+#include <algorithm>
+#include <cmath>
+
+namespace synth {
+
+constexpr int ADDITIVE_MAX_PARTIALS = 256;
+
+/** @brief Partials whose level falls below this (-100 dB) are dropped */
+constexpr float ADDITIVE_SILENCE = 1e-5f;
+
+/**
+ * @struct AdditivePartial
+ * @brief One sine partial of a patch
+ */
+struct AdditivePartial {
+  float ratio = 1.0f; // Frequency multiple of the note
+  float level = 0.0f; // Amplitude at note on
+  float decay = 0.0f; // Seconds to fall 60 dB; 0 holds the level
+};
+
+/**
+ * @struct AdditivePatch
+ * @brief Partial list (stored in SynthPreset)
+ *
+ * The output is scaled by 1 / max(1, sum of levels), so a full patch
+ * never exceeds unity peak.
+ */
+struct AdditivePatch {
+  int count = 0;
+  AdditivePartial partial[ADDITIVE_MAX_PARTIALS];
+
+  /**
+   * @brief Append a partial
+   * @return false when the patch is full
+   */
+  bool add(float ratio, float level, float decay = 0.0f) {
+    if (count >= ADDITIVE_MAX_PARTIALS)
+      return false;
+    partial[count++] = {ratio, level, decay};
+    return true;
+  }
+};
+
+/**
+ * @class AdditiveEngine
+ * @brief One voice of additive synthesis from an AdditivePatch
+ *
+ * Levels and decays are applied once per CONTROL_BLOCK_SIZE samples, with
+ * per-sample gain ramps in between. A note-on, pitch or patch change
+ * rebuilds the partial set at the next control block and restarts every
+ * partial at zero phase.
+ */
+class AdditiveEngine {
+public:
+  void prepare(double sampleRate) {
+    sampleRate_ = sampleRate;
+    dirty_ = true;
+  }
+
+  void setFrequency(Frequency freq) {
+    frequency_ = freq;
+    dirty_ = true;
+  }
+
+  void setPatch(const AdditivePatch &patch) {
+    patch_ = patch;
+    patch_.count = std::clamp(patch.count, 0, ADDITIVE_MAX_PARTIALS);
+    dirty_ = true;
+  }
+
+  const AdditivePatch &getPatch() const { return patch_; }
+
+  void noteOn() { dirty_ = true; }
+
+  /**
+   * @brief Partials currently rendered (after Nyquist and decay culling)
+   */
+  int getActivePartials() const { return active_; }
+
+  Sample process() {
+    Sample output;
+    processBlock(&output, 1);
+    return output;
+  }
+
+  /**
+   * @brief Render a block; levels step once per CONTROL_BLOCK_SIZE
+   *        samples no matter how the block is split
+   */
+  void processBlock(Sample *out, int numSamples) {
+    while (numSamples > 0) {
+      if (controlRemaining_ == 0)
+        startControlBlock();
+      int len = std::min(numSamples, controlRemaining_);
+      render(out, len);
+      out += len;
+      numSamples -= len;
+      controlRemaining_ -= len;
+    }
+  }
+
+private:
+  static_assert(ADDITIVE_MAX_PARTIALS % SIMD_WIDTH == 0,
+                "partial arrays are processed in whole SIMD groups");
+
+  // Rendered partials, packed into the first active_ slots; the rest of
+  // the last group has zero gain so it adds nothing
+  alignas(16) float re_[ADDITIVE_MAX_PARTIALS] = {};
+  alignas(16) float im_[ADDITIVE_MAX_PARTIALS] = {};
+  alignas(16) float cos_[ADDITIVE_MAX_PARTIALS] = {};
+  alignas(16) float sin_[ADDITIVE_MAX_PARTIALS] = {};
+  alignas(16) float gain_[ADDITIVE_MAX_PARTIALS] = {};
+  alignas(16) float gainStep_[ADDITIVE_MAX_PARTIALS] = {};
+  float target_[ADDITIVE_MAX_PARTIALS] = {};   // Level at block end
+  float decayStep_[ADDITIVE_MAX_PARTIALS] = {}; // Per-block multiplier
+
+  AdditivePatch patch_;
+  int active_ = 0;
+  int controlRemaining_ = 0;
+  bool dirty_ = true;
+  double sampleRate_ = DEFAULT_SAMPLE_RATE;
+  Frequency frequency_ = 0.0;
+
+  /**
+   * @brief Pack the audible partials into slots, all at zero phase
+   */
+  void rebuild() {
+    double sum = 0.0;
+    for (int k = 0; k < patch_.count; ++k)
+      sum += std::fabs(patch_.partial[k].level);
+    const double norm = 1.0 / std::max(sum, 1.0);
+    const double nyquist = 0.5 * sampleRate_;
+
+    active_ = 0;
+    for (int k = 0; k < patch_.count; ++k) {
+      const AdditivePartial &p = patch_.partial[k];
+      const double freq = frequency_ * p.ratio;
+      if (p.level == 0.0f || freq <= 0.0 || freq >= nyquist)
+        continue;
+      const double w = TWO_PI * freq / sampleRate_;
+      const int s = active_++;
+      re_[s] = 1.0f;
+      im_[s] = 0.0f;
+      cos_[s] = static_cast<float>(std::cos(w));
+      sin_[s] = static_cast<float>(std::sin(w));
+      gain_[s] = 0.0f;
+      target_[s] = static_cast<float>(p.level * norm);
+      // -60 dB over decay seconds, applied per control block
+      decayStep_[s] =
+          p.decay > 0.0f
+              ? static_cast<float>(std::pow(
+                    0.001, CONTROL_BLOCK_SIZE / (p.decay * sampleRate_)))
+              : 1.0f;
+    }
+    for (int s = active_; s < ADDITIVE_MAX_PARTIALS; ++s)
+      clearSlot(s);
+    dirty_ = false;
+  }
+
+  void clearSlot(int s) {
+    re_[s] = im_[s] = cos_[s] = sin_[s] = 0.0f;
+    gain_[s] = gainStep_[s] = target_[s] = 0.0f;
+    decayStep_[s] = 1.0f;
+  }
+
+  void moveSlot(int from, int to) {
+    re_[to] = re_[from];
+    im_[to] = im_[from];
+    cos_[to] = cos_[from];
+    sin_[to] = sin_[from];
+    gain_[to] = gain_[from];
+    target_[to] = target_[from];
+    decayStep_[to] = decayStep_[from];
+  }
+
+  void startControlBlock() {
+    if (dirty_) {
+      rebuild();
+    } else {
+      // Drop partials that have decayed away (order does not matter);
+      // levels may be negative, so compare magnitudes
+      for (int s = 0; s < active_;) {
+        if (std::fabs(target_[s]) < ADDITIVE_SILENCE &&
+            std::fabs(gain_[s]) < ADDITIVE_SILENCE) {
+          moveSlot(--active_, s);
+          clearSlot(active_);
+        } else {
+          ++s;
+        }
+      }
+    }
+
+    const float ramp = 1.0f / CONTROL_BLOCK_SIZE;
+    for (int k = 0; k < active_; k += SIMD_WIDTH) {
+      // Pull |re + j im| back to 1: the float rotation drifts slowly
+      Float4 re = Float4::load(re_ + k);
+      Float4 im = Float4::load(im_ + k);
+      Float4 fix = Float4(1.5f) - (re * re + im * im) * 0.5f;
+      (re * fix).store(re_ + k);
+      (im * fix).store(im_ + k);
+    }
+    for (int s = 0; s < active_; ++s) {
+      target_[s] *= decayStep_[s];
+      gainStep_[s] = (target_[s] - gain_[s]) * ramp;
+    }
+    controlRemaining_ = CONTROL_BLOCK_SIZE;
+  }
+
+  /**
+   * @brief Sum the active partials into out (numSamples <= control block)
+   *
+   * Partial groups are the outer loop so their state stays in registers
+   * for the whole run; lane sums are reduced once per sample. Each
+   * rotation is a serial multiply-add chain, so four groups run side by
+   * side to fill the pipeline.
+   */
+  void render(Sample *out, int numSamples) {
+    if (active_ == 0) {
+      std::fill(out, out + numSamples, 0.0);
+      return;
+    }
+    Float4 acc[CONTROL_BLOCK_SIZE];
+    for (int i = 0; i < numSamples; ++i)
+      acc[i] = Float4();
+    int k = 0;
+    for (; k + 4 * SIMD_WIDTH <= active_; k += 4 * SIMD_WIDTH)
+      renderGroups<4>(k, acc, numSamples);
+    for (; k < active_; k += SIMD_WIDTH)
+      renderGroups<1>(k, acc, numSamples);
+    for (int i = 0; i < numSamples; ++i)
+      out[i] = horizontalSum(acc[i]);
+  }
+
+  template <int Groups>
+  void renderGroups(int first, Float4 *acc, int numSamples) {
+    Float4 re[Groups], im[Groups], c[Groups], s[Groups], g[Groups],
+        dg[Groups];
+    for (int j = 0; j < Groups; ++j) {
+      const int k = first + j * SIMD_WIDTH;
+      re[j] = Float4::load(re_ + k);
+      im[j] = Float4::load(im_ + k);
+      c[j] = Float4::load(cos_ + k);
+      s[j] = Float4::load(sin_ + k);
+      g[j] = Float4::load(gain_ + k);
+      dg[j] = Float4::load(gainStep_ + k);
+    }
+    for (int i = 0; i < numSamples; ++i) {
+      Float4 sum = acc[i];
+      for (int j = 0; j < Groups; ++j) {
+        sum += im[j] * g[j];
+        Float4 next = re[j] * c[j] - im[j] * s[j];
+        im[j] = re[j] * s[j] + im[j] * c[j];
+        re[j] = next;
+        g[j] += dg[j];
+      }
+      acc[i] = sum;
+    }
+    for (int j = 0; j < Groups; ++j) {
+      const int k = first + j * SIMD_WIDTH;
+      re[j].store(re_ + k);
+      im[j].store(im_ + k);
+      g[j].store(gain_ + k);
+    }
+  }
+};
+
+} // namespace synth
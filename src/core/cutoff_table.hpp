@@ -0,0 +1,166 @@
+#pragma once
+/**
+ * @file cutoff_table.hpp
+ * @brief Shared cutoff -> filter coefficient tables, indexed by pitch
+ *
+ * Every filter coefficient is a smooth function of log2(cutoff), so one
+ * table per curve with CUTOFF_TABLE_STEPS points per octave and linear
+ * interpolation replaces the std::sin / std::tan per cutoff update.
+ * Interpolation error is below 3e-5 relative (0.05 cents) for the sin
+ * and ladder curves; tan steepens towards its pole, reaching 1e-4 at
+ * 0.3 x the rate and 2.5e-3 (4 cents) at the 0.45 x limit.
+ *
+ * Modulation is summed in octaves (envelope, LFO, key tracking), so a
+ * cutoff update is one add chain, two loads and a multiply-add, with no
+ * std::pow on the way in either.
+ *
+ * Tables depend only on the rate a filter core runs at; one set is built
+ * per rate the first time it is asked for and shared by every filter. On
+ * the FPGA each curve is a block ROM addressed by the pitch word.
+ */
+
+#include "types.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace synth {
+
+/** @brief Lowest pitch in the tables: log2(16 Hz) */
+constexpr double CUTOFF_TABLE_MIN_PITCH = 4.0;
+/** @brief Table points per octave */
+constexpr int CUTOFF_TABLE_STEPS = 64;
+
+/** @brief Cutoff range any filter accepts, in Hz and as pitch */
+constexpr Frequency MIN_CUTOFF = 20.0;
+constexpr Frequency MAX_CUTOFF = 20000.0;
+constexpr double MIN_CUTOFF_PITCH = 4.321928094887363;  // log2(20)
+constexpr double MAX_CUTOFF_PITCH = 14.287712379549449; // log2(20000)
+
+/**
+ * @brief Cutoff in Hz to pitch in octaves (log2 Hz)
+ *
+ * Exponent from the bits, mantissa by the atanh series of log2 on
+ * [sqrt(1/2), sqrt(2)): error below 5e-8 octaves, and no libm call, so
+ * Hz-domain cutoff modulation stays cheap too.
+ *
+ * @param hz Cutoff in Hz; must be a positive normal number
+ */
+inline double cutoffToPitch(Frequency hz) {
+  uint64_t bits;
+  std::memcpy(&bits, &hz, sizeof(bits));
+  int exponent = static_cast<int>((bits >> 52) & 0x7ff) - 1023;
+  bits = (bits & 0x000fffffffffffffull) | 0x3ff0000000000000ull;
+  double m;
+  std::memcpy(&m, &bits, sizeof(m));
+  if (m > 1.4142135623730951) {
+    m *= 0.5;
+    ++exponent;
+  }
+  // log2(m) = 2 / ln 2 * atanh(s), s = (m - 1) / (m + 1), |s| < 0.172
+  const double s = (m - 1.0) / (m + 1.0);
+  const double s2 = s * s;
+  return exponent +
+         s * (2.8853900817779268 +
+              s2 * (0.9617966939259756 +
+                    s2 * (0.5770780163555854 + s2 * 0.41219858311113244)));
+}
+
+/**
+ * @enum CutoffCurve
+ * @brief Coefficient curves, one per filter structure
+ */
+enum class CutoffCurve {
+  CHAMBERLIN, // 2 sin(pi fc / fs)
+  TPT,        // tan(pi fc / fs)
+  LADDER,     // wc / (1 + wc), wc = 2 tan(pi fc / fs)
+  COUNT
+};
+
+/**
+ * @class CutoffTable
+ * @brief The curves for one core sample rate
+ *
+ * Entries run from CUTOFF_TABLE_MIN_PITCH up to 0.45 x the core rate
+ * (0.9 x Nyquist); lookups clamp to that range.
+ */
+class CutoffTable {
+public:
+  /**
+   * @brief The shared table for a rate, built on first use
+   *
+   * Allocates the first time a rate is seen: call from prepare() or a
+   * constructor, never the audio thread. Tables live for the process.
+   */
+  static const CutoffTable &forRate(double sampleRate) {
+    static std::mutex mutex;
+    static std::map<double, std::unique_ptr<CutoffTable>> tables;
+
+    std::lock_guard<std::mutex> lock(mutex);
+    auto &table = tables[sampleRate];
+    if (!table)
+      table.reset(new CutoffTable(sampleRate));
+    return *table;
+  }
+
+  double getSampleRate() const { return sampleRate_; }
+
+  /** @brief Highest pitch in the table (0.9 x Nyquist) */
+  double getMaxPitch() const { return maxPitch_; }
+
+  /**
+   * @brief Coefficient for a pitch, linearly interpolated
+   * @param curve Which coefficient
+   * @param pitch Cutoff in octaves (log2 Hz), clamped to the table
+   */
+  Sample lookup(CutoffCurve curve, double pitch) const {
+    const float *t = curves_[static_cast<int>(curve)].data();
+    double pos = (std::clamp(pitch, CUTOFF_TABLE_MIN_PITCH, maxPitch_) -
+                  CUTOFF_TABLE_MIN_PITCH) *
+                 CUTOFF_TABLE_STEPS;
+    int i = static_cast<int>(pos);
+    double frac = pos - i;
+    return t[i] + frac * (t[i + 1] - t[i]);
+  }
+
+private:
+  static constexpr int NUM_CURVES = static_cast<int>(CutoffCurve::COUNT);
+
+  double sampleRate_;
+  double maxPitch_;
+  std::vector<float> curves_[NUM_CURVES];
+
+  std::vector<float> &curve(CutoffCurve c) {
+    return curves_[static_cast<int>(c)];
+  }
+
+  explicit CutoffTable(double sampleRate) : sampleRate_(sampleRate) {
+    maxPitch_ = std::log2(0.45 * sampleRate);
+    // One guard entry past maxPitch_ so the last interpolation stays in
+    const int size = static_cast<int>(std::ceil(
+                         (maxPitch_ - CUTOFF_TABLE_MIN_PITCH) *
+                         CUTOFF_TABLE_STEPS)) +
+                     2;
+    for (auto &curve : curves_)
+      curve.resize(size);
+
+    for (int i = 0; i < size; ++i) {
+      const double pitch =
+          CUTOFF_TABLE_MIN_PITCH + static_cast<double>(i) / CUTOFF_TABLE_STEPS;
+      // Past 0.5 fs tan() wraps; the guard only needs a finite neighbour
+      const double w = std::min(PI * std::exp2(pitch) / sampleRate, 0.49 * PI);
+      const double tanW = std::tan(w);
+      curve(CutoffCurve::CHAMBERLIN)[i] = static_cast<float>(2.0 * std::sin(w));
+      curve(CutoffCurve::TPT)[i] = static_cast<float>(tanW);
+      curve(CutoffCurve::LADDER)[i] =
+          static_cast<float>(2.0 * tanW / (1.0 + 2.0 * tanW));
+    }
+  }
+};
+
+} // namespace synth
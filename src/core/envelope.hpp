@@ -33,6 +33,15 @@ public:
     updateCoefficients();
   }
 
+  /**
+   * @brief Set the sample rate (call before processing)
+   * @param sampleRate Sample rate in Hz
+   */
+  void prepare(double sampleRate) {
+    sampleRate_ = sampleRate;
+    updateCoefficients();
+  }
+
   /**
    * @brief Set attack time
    * @param time Attack time in seconds (0.001 to 10.0)
@@ -128,6 +137,110 @@ public:
     return output_;
   }
 
+  /**
+   * @brief Render a block of envelope values
+   *
+   * Runs each stage as its own tight loop instead of switching per sample.
+   * Output is identical to calling process() numSamples times.
+   *
+   * @param out Output buffer (numSamples long)
+   * @param numSamples Number of samples to render
+   */
+  void processBlock(Sample *out, int numSamples) {
+    int i = 0;
+    while (i < numSamples) {
+      switch (stage_) {
+      case Stage::IDLE:
+        output_ = 0.0;
+        std::fill(out + i, out + numSamples, 0.0);
+        return;
+      case Stage::SUSTAIN:
+        output_ = sustainLevel_;
+        std::fill(out + i, out + numSamples, output_);
+        return;
+      case Stage::ATTACK:
+        while (i < numSamples && stage_ == Stage::ATTACK) {
+          output_ += attackCoef_ * (1.3 - output_);
+          if (output_ >= 1.0) {
+            output_ = 1.0;
+            stage_ = Stage::DECAY;
+          }
+          out[i++] = output_;
+        }
+        break;
+      case Stage::DECAY:
+        while (i < numSamples && stage_ == Stage::DECAY) {
+          output_ += decayCoef_ * (sustainLevel_ - output_);
+          if (output_ <= sustainLevel_ + 0.001) {
+            output_ = sustainLevel_;
+            stage_ = Stage::SUSTAIN;
+          }
+          out[i++] = output_;
+        }
+        break;
+      case Stage::RELEASE:
+        while (i < numSamples && stage_ == Stage::RELEASE) {
+          output_ += releaseCoef_ * (0.0 - output_);
+          if (output_ <= 0.001) {
+            output_ = 0.0;
+            stage_ = Stage::IDLE;
+          }
+          out[i++] = output_;
+        }
+        break;
+      }
+    }
+  }
+
+  /**
+   * @brief Advance the envelope by a whole control block
+   *
+   * A full CONTROL_BLOCK_SIZE step uses precomputed control-rate
+   * coefficients, so the exponential segments land where numSamples
+   * per-sample steps would. Shorter (tail) steps fall back to process().
+   *
+   * @param numSamples Samples to advance (normally CONTROL_BLOCK_SIZE)
+   * @return Envelope value at the end of the step
+   */
+  Sample advance(int numSamples) {
+    if (numSamples != CONTROL_BLOCK_SIZE) {
+      for (int i = 0; i < numSamples; ++i)
+        process();
+      return output_;
+    }
+
+    switch (stage_) {
+    case Stage::IDLE:
+      output_ = 0.0;
+      break;
+    case Stage::ATTACK:
+      output_ += attackCoefCtl_ * (1.3 - output_);
+      if (output_ >= 1.0) {
+        output_ = 1.0;
+        stage_ = Stage::DECAY;
+      }
+      break;
+    case Stage::DECAY:
+      output_ += decayCoefCtl_ * (sustainLevel_ - output_);
+      if (output_ <= sustainLevel_ + 0.001) {
+        output_ = sustainLevel_;
+        stage_ = Stage::SUSTAIN;
+      }
+      break;
+    case Stage::SUSTAIN:
+      output_ = sustainLevel_;
+      break;
+    case Stage::RELEASE:
+      output_ += releaseCoefCtl_ * (0.0 - output_);
+      if (output_ <= 0.001) {
+        output_ = 0.0;
+        stage_ = Stage::IDLE;
+      }
+      break;
+    }
+    return output_;
+  }
+
   /**
    * @brief Check if envelope is active
    * @return true if envelope is not idle
@@ -155,22 +268,33 @@ private:
   double decayTime_;
   Parameter sustainLevel_;
   double releaseTime_;
+  double sampleRate_ = DEFAULT_SAMPLE_RATE;
 
   Sample attackCoef_;
   Sample decayCoef_;
   Sample releaseCoef_;
 
+  // Same curves stepped CONTROL_BLOCK_SIZE samples at a time
+  Sample attackCoefCtl_;
+  Sample decayCoefCtl_;
+  Sample releaseCoefCtl_;
+
   /**
    * @brief Calculate exponential coefficients from times
    */
   void updateCoefficients() {
-    double samplesAttack = attackTime_ * SAMPLE_RATE;
-    double samplesDecay = decayTime_ * SAMPLE_RATE;
-    double samplesRelease = releaseTime_ * SAMPLE_RATE;
+    double samplesAttack = attackTime_ * sampleRate_;
+    double samplesDecay = decayTime_ * sampleRate_;
+    double samplesRelease = releaseTime_ * sampleRate_;
 
     attackCoef_ = 1.0 - std::exp(-2.2 / samplesAttack);
     decayCoef_ = 1.0 - std::exp(-2.2 / samplesDecay);
     releaseCoef_ = 1.0 - std::exp(-2.2 / samplesRelease);
+
+    attackCoefCtl_ = 1.0 - std::exp(-2.2 * CONTROL_BLOCK_SIZE / samplesAttack);
+    decayCoefCtl_ = 1.0 - std::exp(-2.2 * CONTROL_BLOCK_SIZE / samplesDecay);
+    releaseCoefCtl_ =
+        1.0 - std::exp(-2.2 * CONTROL_BLOCK_SIZE / samplesRelease);
   }
 };
 
@@ -9,37 +9,157 @@
  * - Filter drive/saturation
  * - Cutoff frequency modulation
  *
- * Uses the Chamberlin SVF topology, well-suited for FPGA.
+ * Uses the Chamberlin SVF topology, well-suited for FPGA. ZdfFilter is the
+ * same 2-pole response in the zero-delay-feedback (TPT) form: one pass per
+ * sample, stable up to 0.9 x Nyquist, and cheap enough to retune every
+ * sample for audio-rate cutoff modulation.
+ *
+ * Both filters can run 2x or 4x oversampled (default: OVERSAMPLING) to
+ * keep their saturators from aliasing. The SVF is linear without drive,
+ * so it only switches to the higher rate while drive is on.
+ *
+ * Every filter takes its cutoff either in Hz or as pitch (log2 Hz) and
+ * reads its coefficient from the shared CutoffTable for its core rate.
+ * The tables come as a FilterTables, so a filter built on the audio
+ * thread can take ones its owner fetched beforehand.
+ *
+ * Each filter is a template on its saturator (see saturator.hpp); the
+ * plain names are the tiers the voices use.
  */
 
+#include "cutoff_table.hpp"
+#include "oversampler.hpp"
+#include "saturator.hpp"
 #include "types.hpp"
 #include <algorithm>
 
 namespace synth {
 
 /**
- * @class StateVariableFilter
+ * @brief tan(x) for 0 <= x <= 0.45 * pi, as numerator / denominator
+ *
+ * [5/4] Pade approximant. Relative error is below 2.5e-5 (0.04 cents of
+ * cutoff) up to 0.9 x Nyquist. The fraction is returned unevaluated so
+ * callers can fold the division into one of their own.
+ */
+inline void tanFraction(double x, double &num, double &den) {
+  const double x2 = x * x;
+  num = x * (945.0 + x2 * (-105.0 + x2));
+  den = 945.0 + x2 * (-420.0 + 15.0 * x2);
+}
+
+inline double fastTan(double x) {
+  double num, den;
+  tanFraction(x, num, den);
+  return num / den;
+}
+
+/**
+ * @struct FilterTables
+ * @brief A filter's coefficient tables, at 1x and at the oversampled rate
+ *
+ * Fetching takes the table registry's lock and may build a table, so
+ * owners fetch in prepare() and pass the result to the constructor of any
+ * filter they build on the audio thread.
+ */
+struct FilterTables {
+  const CutoffTable *base = nullptr;
+  const CutoffTable *over = nullptr;
+
+  /** @brief Fetch the tables for a rate (not on the audio thread) */
+  static FilterTables forRate(double sampleRate, int oversampling) {
+    return {&CutoffTable::forRate(sampleRate),
+            &CutoffTable::forRate(sampleRate * oversampling)};
+  }
+};
+
+/**
+ * @class BasicStateVariableFilter
  * @brief 2-pole resonant filter with multiple outputs
  *
  * The SVF provides simultaneous LP, HP, BP, and Notch outputs.
  * This topology is numerically stable and maps well to fixed-point.
+ *
+ * @tparam Saturator Drive curve (a saturator.hpp tier)
  */
-class StateVariableFilter {
+template <typename Saturator> class BasicStateVariableFilter {
 public:
-  StateVariableFilter()
-      : cutoff_(1000.0), resonance_(0.0), drive_(0.0),
+  BasicStateVariableFilter()
+      : BasicStateVariableFilter(
+            DEFAULT_SAMPLE_RATE, OVERSAMPLING,
+            FilterTables::forRate(DEFAULT_SAMPLE_RATE, OVERSAMPLING)) {}
+
+  /**
+   * @brief Build for a rate with tables already fetched for it; safe on
+   *        the audio thread
+   */
+  BasicStateVariableFilter(double sampleRate, int oversampling,
+                           const FilterTables &tables)
+      : pitch_(cutoffToPitch(1000.0)), resonance_(0.0), drive_(0.0),
         mode_(FilterMode::LOWPASS), lowpass_(0.0), highpass_(0.0),
         bandpass_(0.0), notch_(0.0) {
-    updateCoefficients();
+    configure(sampleRate, oversampling, tables);
   }
 
+  /**
+   * @brief Set the sample rate (call before processing)
+   * @param sampleRate Sample rate in Hz
+   */
+  void prepare(double sampleRate) {
+    const int factor = oversampler_.getFactor();
+    configure(sampleRate, factor, FilterTables::forRate(sampleRate, factor));
+  }
+
+  /**
+   * @brief Oversampling factor used while drive is on (1, 2 or 4)
+   */
+  void setOversampling(int factor) {
+    configure(sampleRate_, factor, FilterTables::forRate(sampleRate_, factor));
+  }
+
+  int getOversampling() const { return oversampler_.getFactor(); }
+
   /**
    * @brief Set cutoff frequency
    * @param freq Cutoff frequency in Hz (20 - 20000)
    */
   void setCutoff(Frequency freq) {
-    cutoff_ = std::clamp(freq, 20.0, NYQUIST * 0.9);
-    updateCoefficients();
+    setCutoffPitch(cutoffToPitch(std::max(freq, MIN_CUTOFF)));
+  }
+
+  /**
+   * @brief Set cutoff as pitch
+   * @param pitch Cutoff in octaves, log2(Hz)
+   */
+  void setCutoffPitch(double pitch) {
+    pitch_ = std::clamp(pitch, MIN_CUTOFF_PITCH, maxPitch_);
+    f_ = std::min(table_->lookup(CutoffCurve::CHAMBERLIN, pitch_), fMax_);
+    fTarget_ = f_;
+    rampSamples_ = 0;
+  }
+
+  /**
+   * @brief Glide the cutoff to a new value over the next samples
+   *
+   * The frequency coefficient is interpolated linearly by processBlock(),
+   * so a control-rate cutoff update costs one table lookup per ramp
+   * instead of one per sample, without zipper noise.
+   *
+   * @param freq Target cutoff frequency in Hz
+   * @param numSamples Ramp length in samples
+   */
+  void rampCutoff(Frequency freq, int numSamples) {
+    rampCutoffPitch(cutoffToPitch(std::max(freq, MIN_CUTOFF)), numSamples);
+  }
+
+  /**
+   * @brief rampCutoff() with the target as pitch, log2(Hz)
+   */
+  void rampCutoffPitch(double pitch, int numSamples) {
+    pitch_ = std::clamp(pitch, MIN_CUTOFF_PITCH, maxPitch_);
+    fTarget_ = std::min(table_->lookup(CutoffCurve::CHAMBERLIN, pitch_), fMax_);
+    rampSamples_ = std::max(numSamples, 1) * rateFactor_;
+    fStep_ = (fTarget_ - f_) / rampSamples_;
   }
 
   /**
@@ -55,7 +175,11 @@ public:
    * @brief Set filter drive (saturation)
    * @param drv Drive amount (0.0 = clean, 1.0 = heavy saturation)
    */
-  void setDrive(Parameter drv) { drive_ = std::clamp(drv, 0.0, 1.0); }
+  void setDrive(Parameter drv) {
+    drive_ = std::clamp(drv, 0.0, 1.0);
+    if (activeFactor() != rateFactor_)
+      updateRate();
+  }
 
   /**
    * @brief Set filter mode
@@ -69,44 +193,41 @@ public:
    * @return Filtered output sample
    */
   Sample process(Sample input) {
-    if (drive_ > 0.0) {
-      input = softClip(input * (1.0 + drive_ * 3.0));
-    }
-
-    for (int i = 0; i < 2; ++i) {
-      lowpass_ += f_ * bandpass_;
-      highpass_ = input - lowpass_ - q_ * bandpass_;
-      bandpass_ += f_ * highpass_;
-      notch_ = highpass_ + lowpass_;
-    }
+    if (rateFactor_ > 1)
+      return oversampler_.processSample(
+          input, [this](Sample x) { return tick(x); });
+    return tick(input);
+  }
 
-    Sample output;
+  /**
+   * @brief Filter a block in place, advancing any pending cutoff ramp
+   * @param buffer Samples to filter (numSamples long)
+   * @param numSamples Number of samples
+   */
+  void processBlock(Sample *buffer, int numSamples) {
     switch (mode_) {
-    case FilterMode::LOWPASS:
-      output = lowpass_;
-      break;
     case FilterMode::HIGHPASS:
-      output = highpass_;
+      processBlockMode<FilterMode::HIGHPASS>(buffer, numSamples);
       break;
     case FilterMode::BANDPASS:
-      output = bandpass_;
+      processBlockMode<FilterMode::BANDPASS>(buffer, numSamples);
       break;
     case FilterMode::NOTCH:
-      output = notch_;
+      processBlockMode<FilterMode::NOTCH>(buffer, numSamples);
       break;
+    case FilterMode::LOWPASS:
     default:
-      output = lowpass_;
-    }
-
-    if (drive_ > 0.5) {
-      output = softClip(output);
+      processBlockMode<FilterMode::LOWPASS>(buffer, numSamples);
+      break;
     }
-
-    return output;
   }
 
   /**
    * @brief Get all filter outputs simultaneously
+   *
+   * When oversampled, the outputs are those of the last high-rate step
+   * (plain decimation, no half-band on the four taps).
+   *
    * @param input Input sample
    * @param lp Low-pass output
    * @param hp High-pass output
@@ -115,16 +236,14 @@ public:
    */
   void processMultiMode(Sample input, Sample &lp, Sample &hp, Sample &bp,
                         Sample &notch) {
-    if (drive_ > 0.0) {
-      input = softClip(input * (1.0 + drive_ * 3.0));
-    }
-
-    for (int i = 0; i < 2; ++i) {
-      lowpass_ += f_ * bandpass_;
-      highpass_ = input - lowpass_ - q_ * bandpass_;
-      bandpass_ += f_ * highpass_;
-      notch_ = highpass_ + lowpass_;
-    }
+    auto step = [this](Sample x) {
+      stepCore(drive_ > 0.0 ? softClip(x * (1.0 + drive_ * 3.0)) : x);
+      return lowpass_;
+    };
+    if (rateFactor_ > 1)
+      oversampler_.processSample(input, step);
+    else
+      step(input);
 
     lp = lowpass_;
     hp = highpass_;
@@ -140,10 +259,11 @@ public:
     highpass_ = 0.0;
     bandpass_ = 0.0;
     notch_ = 0.0;
+    oversampler_.reset();
   }
 
 private:
-  Frequency cutoff_;
+  double pitch_; // Cutoff, log2(Hz)
   Parameter resonance_;
   Parameter drive_;
   FilterMode mode_;
@@ -155,51 +275,584 @@ private:
 
   Sample f_;
   Sample q_;
+  Sample fMax_; // Largest stable f for q_ (see updateCoefficients)
+
+  // Rate-dependent constants (see prepare); the coefficients are for
+  // sampleRate_ * rateFactor_, the rate the core actually runs at
+  double sampleRate_ = DEFAULT_SAMPLE_RATE;
+  double maxPitch_ = cutoffToPitch(DEFAULT_SAMPLE_RATE * 0.5 * 0.9);
+  int rateFactor_ = 1;
+  Oversampler oversampler_;
+
+  // Coefficient tables at 1x and at the oversampled rate; fetched outside
+  // the audio thread so a drive change never builds one
+  FilterTables tables_;
+  const CutoffTable *table_ = nullptr;
+
+  // Cutoff ramp state (see rampCutoff)
+  Sample fTarget_ = 0.0;
+  Sample fStep_ = 0.0;
+  int rampSamples_ = 0;
+
+  /**
+   * @brief Factor the core should run at: oversample only when driven
+   */
+  int activeFactor() const {
+    return drive_ > 0.0 ? oversampler_.getFactor() : 1;
+  }
+
+  /**
+   * @brief Re-derive the core rate and the coefficients for it
+   *
+   * Cancels any pending cutoff ramp (drive and oversampling changes are
+   * rare, panel-rate events).
+   */
+  void updateRate() {
+    rateFactor_ = activeFactor();
+    table_ = rateFactor_ > 1 ? tables_.over : tables_.base;
+    oversampler_.reset();
+    updateCoefficients();
+  }
+
+  void configure(double sampleRate, int factor, const FilterTables &tables) {
+    sampleRate_ = sampleRate;
+    maxPitch_ = cutoffToPitch(sampleRate * 0.5 * 0.9);
+    oversampler_.setFactor(factor);
+    tables_ = tables;
+    updateRate();
+  }
+
+  // Two Chamberlin iterations per (possibly oversampled) sample
+  void stepCore(Sample input) {
+    for (int i = 0; i < 2; ++i) {
+      lowpass_ += f_ * bandpass_;
+      highpass_ = input - lowpass_ - q_ * bandpass_;
+      bandpass_ += f_ * highpass_;
+      notch_ = highpass_ + lowpass_;
+    }
+  }
+
+  // One sample at the core rate, all modes (per-sample path)
+  Sample tick(Sample input) {
+    if (drive_ > 0.0) {
+      input = softClip(input * (1.0 + drive_ * 3.0));
+    }
+
+    stepCore(input);
+
+    Sample output;
+    switch (mode_) {
+    case FilterMode::LOWPASS:
+      output = lowpass_;
+      break;
+    case FilterMode::HIGHPASS:
+      output = highpass_;
+      break;
+    case FilterMode::BANDPASS:
+      output = bandpass_;
+      break;
+    case FilterMode::NOTCH:
+      output = notch_;
+      break;
+    default:
+      output = lowpass_;
+    }
+
+    if (drive_ > 0.5) {
+      output = softClip(output);
+    }
+
+    return output;
+  }
 
   /**
-   * @brief Update filter coefficients when parameters change
+   * @brief Update the resonance-dependent coefficients, then f
    */
   void updateCoefficients() {
-    f_ = 2.0 * std::sin(PI * cutoff_ / SAMPLE_RATE);
     q_ = 2.0 - 2.0 * resonance_;
+    // The Chamberlin loop is stable for f < sqrt(q^2 + 4) - q. At 192 kHz
+    // audible cutoffs never get close, but at 48 kHz high cutoffs would
+    // blow up.
+    fMax_ = 0.9 * (std::sqrt(q_ * q_ + 4.0) - q_);
+    setCutoffPitch(pitch_);
+  }
+
+  template <FilterMode Mode> void processBlockMode(Sample *buffer, int n) {
+    if (rateFactor_ > 1) {
+      oversampler_.processBlock(buffer, n, [this](Sample *hi, int m) {
+        processCoreBlock<Mode>(hi, m);
+      });
+    } else {
+      processCoreBlock<Mode>(buffer, n);
+    }
+  }
+
+  // Block loop at the core rate
+  template <FilterMode Mode> void processCoreBlock(Sample *buffer, int n) {
+    const Sample inputGain = 1.0 + drive_ * 3.0;
+    const bool driveIn = drive_ > 0.0;
+    const bool driveOut = drive_ > 0.5;
+    const int rampLen = std::min(rampSamples_, n);
+
+    for (int i = 0; i < n; ++i) {
+      if (i < rampLen)
+        f_ += fStep_;
+
+      Sample input = buffer[i];
+      if (driveIn)
+        input = softClip(input * inputGain);
+
+      for (int k = 0; k < 2; ++k) {
+        lowpass_ += f_ * bandpass_;
+        highpass_ = input - lowpass_ - q_ * bandpass_;
+        bandpass_ += f_ * highpass_;
+      }
+      notch_ = highpass_ + lowpass_;
+
+      Sample output = (Mode == FilterMode::HIGHPASS)   ? highpass_
+                      : (Mode == FilterMode::BANDPASS) ? bandpass_
+                      : (Mode == FilterMode::NOTCH)    ? notch_
+                                                       : lowpass_;
+      buffer[i] = driveOut ? softClip(output) : output;
+    }
+
+    rampSamples_ -= rampLen;
+    if (rampLen > 0 && rampSamples_ == 0)
+      f_ = fTarget_;
+  }
+
+  static Sample softClip(Sample x) { return Saturator::process(x); }
+};
+
+using StateVariableFilter = BasicStateVariableFilter<RationalClip>;
+
+/**
+ * @class BasicZdfFilter
+ * @brief 2-pole zero-delay-feedback (TPT) state variable filter
+ *
+ * Trapezoidal integrators with the feedback loop solved in closed form:
+ * g = tan(pi * fc / fs), k = 1 / Q, and every sample
+ *
+ *   v1 = a1 * ic1 + a2 * (x - ic2)       (band-pass)
+ *   v2 = ic2 + a2 * ic1 + a3 * (x - ic2) (low-pass)
+ *
+ * with a1 = 1 / (1 + g (g + k)), a2 = g a1, a3 = g a2. High-pass and
+ * notch follow from x, v1 and v2, so all four outputs come out of one
+ * pass. The response matches the analog prototype with the cutoff
+ * prewarped exactly, and the structure is stable for any g > 0, so no
+ * second iteration or cutoff limit below 0.9 x Nyquist is needed.
+ *
+ * g comes from the shared TPT table for control-rate updates, and from
+ * fastTan() when processBlock() is given a per-sample cutoff in Hz:
+ * retuning then costs about ten multiplies and one division per sample.
+ *
+ * @tparam Saturator Drive curve (a saturator.hpp tier)
+ */
+template <typename Saturator> class BasicZdfFilter {
+public:
+  BasicZdfFilter()
+      : BasicZdfFilter(
+            DEFAULT_SAMPLE_RATE, OVERSAMPLING,
+            FilterTables::forRate(DEFAULT_SAMPLE_RATE, OVERSAMPLING)) {}
+
+  /**
+   * @brief Build for a rate with tables already fetched for it; safe on
+   *        the audio thread
+   */
+  BasicZdfFilter(double sampleRate, int oversampling,
+                 const FilterTables &tables) {
+    configure(sampleRate, oversampling, tables);
+  }
+
+  /**
+   * @brief Set the sample rate (call before processing)
+   * @param sampleRate Sample rate in Hz
+   */
+  void prepare(double sampleRate) {
+    const int factor = oversampler_.getFactor();
+    configure(sampleRate, factor, FilterTables::forRate(sampleRate, factor));
   }
 
   /**
-   * @brief Soft clipping saturation (tanh approximation)
-   * @param x Input value
-   * @return Clipped value
+   * @brief Oversampling factor used while drive is on (1, 2 or 4)
    */
-  static Sample softClip(Sample x) {
-    if (x > 3.0)
-      return 1.0;
-    if (x < -3.0)
-      return -1.0;
-    Sample x2 = x * x;
-    return x * (27.0 + x2) / (27.0 + 9.0 * x2);
+  void setOversampling(int factor) {
+    configure(sampleRate_, factor, FilterTables::forRate(sampleRate_, factor));
+  }
+
+  int getOversampling() const { return oversampler_.getFactor(); }
+
+  /**
+   * @brief Set cutoff frequency
+   * @param freq Cutoff frequency in Hz (20 to 0.9 x Nyquist)
+   */
+  void setCutoff(Frequency freq) {
+    setCutoffPitch(cutoffToPitch(std::max(freq, MIN_CUTOFF)));
+  }
+
+  /**
+   * @brief Set cutoff as pitch
+   * @param pitch Cutoff in octaves, log2(Hz)
+   */
+  void setCutoffPitch(double pitch) {
+    pitch_ = std::clamp(pitch, MIN_CUTOFF_PITCH, maxPitch_);
+    g_ = table_->lookup(CutoffCurve::TPT, pitch_);
+    gTarget_ = g_;
+    rampSamples_ = 0;
+    updateCoefficients();
+  }
+
+  /**
+   * @brief Glide the cutoff to a new value over the next samples
+   *
+   * g is interpolated linearly by processBlock(), with the a1..a3 update
+   * (one division) done per sample while the ramp runs.
+   *
+   * @param freq Target cutoff frequency in Hz
+   * @param numSamples Ramp length in samples
+   */
+  void rampCutoff(Frequency freq, int numSamples) {
+    rampCutoffPitch(cutoffToPitch(std::max(freq, MIN_CUTOFF)), numSamples);
+  }
+
+  /**
+   * @brief rampCutoff() with the target as pitch, log2(Hz)
+   */
+  void rampCutoffPitch(double pitch, int numSamples) {
+    pitch_ = std::clamp(pitch, MIN_CUTOFF_PITCH, maxPitch_);
+    gTarget_ = table_->lookup(CutoffCurve::TPT, pitch_);
+    rampSamples_ = std::max(numSamples, 1) * rateFactor_;
+    gStep_ = (gTarget_ - g_) / rampSamples_;
+  }
+
+  /**
+   * @brief Set resonance
+   * @param res Resonance amount (0.0 = Q 0.5, 0.99 = Q 50)
+   */
+  void setResonance(Parameter res) {
+    resonance_ = std::clamp(res, 0.0, 0.99);
+    k_ = 2.0 - 2.0 * resonance_;
+    updateCoefficients();
+  }
+
+  /**
+   * @brief Set filter drive (saturation)
+   * @param drv Drive amount (0.0 = clean, 1.0 = heavy saturation)
+   */
+  void setDrive(Parameter drv) {
+    drive_ = std::clamp(drv, 0.0, 1.0);
+    if (activeFactor() != rateFactor_)
+      updateRate();
+  }
+
+  void setMode(FilterMode m) { mode_ = m; }
+
+  /**
+   * @brief Process one sample
+   * @param input Input sample
+   * @return Filtered output sample
+   */
+  Sample process(Sample input) {
+    processBlock(&input, 1);
+    return input;
+  }
+
+  /**
+   * @brief Filter a block in place, advancing any pending cutoff ramp
+   * @param buffer Samples to filter (numSamples long)
+   * @param numSamples Number of samples
+   */
+  void processBlock(Sample *buffer, int numSamples) {
+    dispatch<false>(buffer, nullptr, numSamples);
+  }
+
+  /**
+   * @brief Filter a block with a new cutoff every sample
+   *
+   * Replaces any pending ramp; the last cutoff stays in effect afterwards.
+   * When oversampled, each cutoff value is held for its high-rate samples.
+   *
+   * @param buffer Samples to filter (numSamples long)
+   * @param cutoff Cutoff in Hz per sample (numSamples long)
+   * @param numSamples Number of samples
+   */
+  void processBlock(Sample *buffer, const Sample *cutoff, int numSamples) {
+    if (numSamples <= 0)
+      return;
+    rampSamples_ = 0;
+    dispatch<true>(buffer, cutoff, numSamples);
+    setCutoff(cutoff[numSamples - 1]);
+  }
+
+  /**
+   * @brief Get all filter outputs of one sample
+   *
+   * When oversampled, the outputs are those of the last high-rate step.
+   */
+  void processMultiMode(Sample input, Sample &lp, Sample &hp, Sample &bp,
+                        Sample &notch) {
+    processRate<FilterMode::LOWPASS, false>(&input, nullptr, 1);
+    lp = lowpass_;
+    bp = bandpass_;
+    hp = highpass_;
+    notch = lowpass_ + highpass_;
+  }
+
+  /**
+   * @brief Reset filter state (on note-on to prevent clicks)
+   */
+  void reset() {
+    ic1_ = ic2_ = 0.0;
+    lowpass_ = bandpass_ = highpass_ = 0.0;
+    oversampler_.reset();
+  }
+
+private:
+  double pitch_ = cutoffToPitch(1000.0); // Cutoff, log2(Hz)
+  Parameter resonance_ = 0.0;
+  Parameter drive_ = 0.0;
+  FilterMode mode_ = FilterMode::LOWPASS;
+
+  // Integrator states and the last outputs (for processMultiMode)
+  Sample ic1_ = 0.0, ic2_ = 0.0;
+  Sample lowpass_ = 0.0, bandpass_ = 0.0, highpass_ = 0.0;
+
+  Sample g_ = 0.0, k_ = 2.0;
+  Sample a1_ = 1.0, a2_ = 0.0, a3_ = 0.0;
+
+  double sampleRate_ = DEFAULT_SAMPLE_RATE;
+  double piOverSampleRate_ = PI / DEFAULT_SAMPLE_RATE; // At the core rate
+  double maxPitch_ = cutoffToPitch(DEFAULT_SAMPLE_RATE * 0.5 * 0.9);
+  int rateFactor_ = 1;
+  Oversampler oversampler_;
+
+  // Tables at 1x and at the oversampled rate (see StateVariableFilter)
+  FilterTables tables_;
+  const CutoffTable *table_ = nullptr;
+
+  // Cutoff ramp state (see rampCutoff)
+  Sample gTarget_ = 0.0;
+  Sample gStep_ = 0.0;
+  int rampSamples_ = 0;
+
+  int activeFactor() const {
+    return drive_ > 0.0 ? oversampler_.getFactor() : 1;
+  }
+
+  void updateRate() {
+    rateFactor_ = activeFactor();
+    piOverSampleRate_ = PI / (sampleRate_ * rateFactor_);
+    table_ = rateFactor_ > 1 ? tables_.over : tables_.base;
+    oversampler_.reset();
+    setCutoffPitch(pitch_);
+  }
+
+  void configure(double sampleRate, int factor, const FilterTables &tables) {
+    sampleRate_ = sampleRate;
+    maxPitch_ = cutoffToPitch(sampleRate * 0.5 * 0.9);
+    oversampler_.setFactor(factor);
+    tables_ = tables;
+    updateRate();
+  }
+
+  void updateCoefficients() {
+    a1_ = 1.0 / (1.0 + g_ * (g_ + k_));
+    a2_ = g_ * a1_;
+    a3_ = g_ * a2_;
+  }
+
+  template <bool Modulated>
+  void dispatch(Sample *buffer, const Sample *cutoff, int n) {
+    switch (mode_) {
+    case FilterMode::HIGHPASS:
+      processRate<FilterMode::HIGHPASS, Modulated>(buffer, cutoff, n);
+      break;
+    case FilterMode::BANDPASS:
+      processRate<FilterMode::BANDPASS, Modulated>(buffer, cutoff, n);
+      break;
+    case FilterMode::NOTCH:
+      processRate<FilterMode::NOTCH, Modulated>(buffer, cutoff, n);
+      break;
+    case FilterMode::LOWPASS:
+    default:
+      processRate<FilterMode::LOWPASS, Modulated>(buffer, cutoff, n);
+      break;
+    }
+  }
+
+  template <FilterMode M, bool Modulated>
+  void processRate(Sample *buffer, const Sample *cutoff, int n) {
+    if (rateFactor_ == 1) {
+      processCore<M, Modulated>(buffer, cutoff, n, 1);
+      return;
+    }
+    // Walk the oversampler's chunks so the cutoff stays in step
+    for (int offset = 0; offset < n; offset += Oversampler::CHUNK) {
+      const int len = std::min(Oversampler::CHUNK, n - offset);
+      const Sample *fc = Modulated ? cutoff + offset : nullptr;
+      oversampler_.processBlock(
+          buffer + offset, len, [this, fc](Sample *hi, int m) {
+            processCore<M, Modulated>(hi, fc, m, rateFactor_);
+          });
+    }
+  }
+
+  /**
+   * @brief Block loop at the core rate
+   * @param hold High-rate samples per cutoff value
+   */
+  template <FilterMode M, bool Modulated>
+  void processCore(Sample *buffer, const Sample *cutoff, int n, int hold) {
+    if (n <= 0)
+      return;
+    const Sample inputGain = 1.0 + drive_ * 3.0;
+    const bool driveIn = drive_ > 0.0;
+    const bool driveOut = drive_ > 0.5;
+    const Sample k = k_;
+    const Sample lo = piOverSampleRate_ * MIN_CUTOFF;
+    const Sample hi = piOverSampleRate_ * std::exp2(maxPitch_);
+    const int rampLen = Modulated ? 0 : std::min(rampSamples_, n);
+    Sample ic1 = ic1_, ic2 = ic2_;
+    Sample a1 = a1_, a2 = a2_, a3 = a3_, g = g_;
+    Sample v0 = 0.0, v1 = 0.0, v2 = 0.0;
+
+    for (int i = 0; i < n; ++i) {
+      if (Modulated) {
+        // a1 = den^2 / (den^2 + num (num + k den)), one division
+        Sample num, den;
+        tanFraction(std::clamp(cutoff[i / hold] * piOverSampleRate_, lo, hi),
+                    num, den);
+        const Sample r = 1.0 / (den * den + num * (num + k * den));
+        a1 = den * den * r;
+        a2 = num * den * r;
+        a3 = num * num * r;
+      } else if (i < rampLen) {
+        // Counted back from the target: exact at the end, any block split
+        g = gTarget_ - gStep_ * (rampSamples_ - 1 - i);
+        a1 = 1.0 / (1.0 + g * (g + k));
+        a2 = g * a1;
+        a3 = g * a2;
+      }
+
+      v0 = buffer[i];
+      if (driveIn)
+        v0 = Saturator::process(v0 * inputGain);
+      const Sample v3 = v0 - ic2;
+      v1 = a1 * ic1 + a2 * v3;
+      v2 = ic2 + a2 * ic1 + a3 * v3;
+      ic1 = 2.0 * v1 - ic1;
+      ic2 = 2.0 * v2 - ic2;
+
+      Sample output = (M == FilterMode::HIGHPASS)   ? v0 - k * v1 - v2
+                      : (M == FilterMode::BANDPASS) ? v1
+                      : (M == FilterMode::NOTCH)    ? v0 - k * v1
+                                                    : v2;
+      buffer[i] = driveOut ? Saturator::process(output) : output;
+    }
+
+    ic1_ = ic1;
+    ic2_ = ic2;
+    lowpass_ = v2;
+    bandpass_ = v1;
+    highpass_ = v0 - k * v1 - v2;
+    if (rampLen > 0) {
+      g_ = g;
+      rampSamples_ -= rampLen;
+      updateCoefficients();
+    }
   }
 };
 
+using ZdfFilter = BasicZdfFilter<RationalClip>;
+
 /**
- * @class LadderFilter
+ * @class BasicLadderFilter
  * @brief 4-pole 24dB/oct Moog-style ladder filter
  *
  * More computationally expensive but provides that classic ladder sound.
  * Good for FPGA since it's just a cascade of 1-pole filters.
+ *
+ * @tparam Saturator Curve of the input and the four stages; it runs five
+ *         times per core sample, so the tier sets the filter's cost
  */
-class LadderFilter {
+template <typename Saturator> class BasicLadderFilter {
 public:
-  LadderFilter() : cutoff_(1000.0), resonance_(0.0) {
+  BasicLadderFilter()
+      : BasicLadderFilter(
+            DEFAULT_SAMPLE_RATE, OVERSAMPLING,
+            FilterTables::forRate(DEFAULT_SAMPLE_RATE, OVERSAMPLING)) {}
+
+  /**
+   * @brief Build for a rate with tables already fetched for it; safe on
+   *        the audio thread
+   */
+  BasicLadderFilter(double sampleRate, int oversampling,
+                    const FilterTables &tables)
+      : pitch_(cutoffToPitch(1000.0)), resonance_(0.0) {
     reset();
-    updateCoefficients();
+    configure(sampleRate, oversampling, tables);
+  }
+
+  /**
+   * @brief Set the sample rate (call before processing)
+   * @param sampleRate Sample rate in Hz
+   */
+  void prepare(double sampleRate) {
+    const int factor = oversampler_.getFactor();
+    configure(sampleRate, factor, FilterTables::forRate(sampleRate, factor));
   }
 
+  /**
+   * @brief Oversampling factor for the whole ladder (1, 2 or 4)
+   *
+   * Every stage saturates, so unlike the SVF this applies at all times.
+   */
+  void setOversampling(int factor) {
+    configure(sampleRate_, factor, FilterTables::forRate(sampleRate_, factor));
+  }
+
+  int getOversampling() const { return oversampler_.getFactor(); }
+
   /**
    * @brief Set cutoff frequency
    * @param freq Cutoff frequency in Hz
    */
   void setCutoff(Frequency freq) {
-    cutoff_ = std::clamp(freq, 20.0, NYQUIST * 0.45);
-    updateCoefficients();
+    setCutoffPitch(cutoffToPitch(std::max(freq, MIN_CUTOFF)));
+  }
+
+  /**
+   * @brief Set cutoff as pitch
+   * @param pitch Cutoff in octaves, log2(Hz)
+   */
+  void setCutoffPitch(double pitch) {
+    pitch_ = std::clamp(pitch, MIN_CUTOFF_PITCH, maxPitch_);
+    g_ = table_->lookup(CutoffCurve::LADDER, pitch_);
+    gTarget_ = g_;
+    rampSamples_ = 0;
+  }
+
+  /**
+   * @brief Glide the cutoff to a new value over the next samples
+   *
+   * As the SVF: the stage coefficient is interpolated linearly by
+   * processBlock().
+   *
+   * @param freq Target cutoff frequency in Hz
+   * @param numSamples Ramp length in samples
+   */
+  void rampCutoff(Frequency freq, int numSamples) {
+    rampCutoffPitch(cutoffToPitch(std::max(freq, MIN_CUTOFF)), numSamples);
+  }
+
+  /**
+   * @brief rampCutoff() with the target as pitch, log2(Hz)
+   */
+  void rampCutoffPitch(double pitch, int numSamples) {
+    pitch_ = std::clamp(pitch, MIN_CUTOFF_PITCH, maxPitch_);
+    gTarget_ = table_->lookup(CutoffCurve::LADDER, pitch_);
+    rampSamples_ = std::max(numSamples, 1) * oversampler_.getFactor();
+    gStep_ = (gTarget_ - g_) / rampSamples_;
   }
 
   /**
@@ -211,21 +864,39 @@ public:
     k_ = 4.0 * resonance_;
   }
 
+  /**
+   * @brief Set drive: input gain into the saturating stages, 1x to 4x
+   * @param drv Drive amount (0.0 to 1.0)
+   */
+  void setDrive(Parameter drv) {
+    drive_ = std::clamp(drv, 0.0, 1.0);
+    inputGain_ = 1.0 + drive_ * 3.0;
+  }
+
+  /**
+   * @brief Accepted for interface parity with the SVFs; always low-pass
+   */
+  void setMode(FilterMode) {}
+
   /**
    * @brief Process one sample
    * @param input Input sample
    * @return Filtered output
    */
   Sample process(Sample input) {
-    Sample feedback = stage_[3] * k_;
-    input = softClip(input - feedback);
-
-    for (int i = 0; i < 4; ++i) {
-      Sample prev = (i == 0) ? input : stage_[i - 1];
-      stage_[i] += g_ * (softClip(prev) - stage_[i]);
-    }
+    return oversampler_.processSample(input,
+                                      [this](Sample x) { return tick(x); });
+  }
 
-    return stage_[3];
+  /**
+   * @brief Filter a block in place
+   * @param buffer Samples to filter (numSamples long)
+   * @param numSamples Number of samples
+   */
+  void processBlock(Sample *buffer, int numSamples) {
+    oversampler_.processBlock(buffer, numSamples, [this](Sample *hi, int n) {
+      processCore(hi, n);
+    });
   }
 
   /**
@@ -235,21 +906,83 @@ public:
     for (int i = 0; i < 4; ++i) {
       stage_[i] = 0.0;
     }
+    oversampler_.reset();
   }
 
 private:
-  Frequency cutoff_;
+  double pitch_; // Cutoff, log2(Hz)
   Parameter resonance_;
   Sample stage_[4];
   Sample g_;
-  Sample k_;
+  Sample k_ = 0.0;
+  Parameter drive_ = 0.0;
+  Sample inputGain_ = 1.0;
+  double sampleRate_ = DEFAULT_SAMPLE_RATE;
+  double maxPitch_ = cutoffToPitch(DEFAULT_SAMPLE_RATE * 0.5 * 0.45);
+  Oversampler oversampler_;
+  const CutoffTable *table_ = nullptr; // At the core rate
+
+  // Cutoff ramp state (see rampCutoff)
+  Sample gTarget_ = 0.0;
+  Sample gStep_ = 0.0;
+  int rampSamples_ = 0;
+
+  // Always oversampled, so only the oversampled table is used; rate
+  // changes are panel-rate calls
+  void configure(double sampleRate, int factor, const FilterTables &tables) {
+    sampleRate_ = sampleRate;
+    maxPitch_ = cutoffToPitch(sampleRate * 0.5 * 0.45);
+    oversampler_.setFactor(factor);
+    table_ = tables.over;
+    oversampler_.reset();
+    setCutoffPitch(pitch_);
+  }
 
-  void updateCoefficients() {
-    Sample wc = 2.0 * std::tan(PI * cutoff_ / SAMPLE_RATE);
-    g_ = wc / (1.0 + wc);
+  // One sample at the core rate
+  Sample tick(Sample input) {
+    Sample feedback = stage_[3] * k_;
+    input = softClip(input * inputGain_ - feedback);
+
+    for (int i = 0; i < 4; ++i) {
+      Sample prev = (i == 0) ? input : stage_[i - 1];
+      stage_[i] += g_ * (softClip(prev) - stage_[i]);
+    }
+
+    return stage_[3];
   }
 
-  static Sample softClip(Sample x) { return std::tanh(x); }
+  // Block loop at the core rate: tick() with the stages in registers
+  // and the cutoff ramp applied
+  void processCore(Sample *buffer, int n) {
+    const int rampLen = std::min(rampSamples_, n);
+    Sample s0 = stage_[0], s1 = stage_[1], s2 = stage_[2], s3 = stage_[3];
+    Sample g = g_;
+
+    for (int i = 0; i < n; ++i) {
+      if (i < rampLen)
+        g += gStep_;
+
+      const Sample input = softClip(buffer[i] * inputGain_ - s3 * k_);
+      s0 += g * (softClip(input) - s0);
+      s1 += g * (softClip(s0) - s1);
+      s2 += g * (softClip(s1) - s2);
+      s3 += g * (softClip(s2) - s3);
+      buffer[i] = s3;
+    }
+
+    stage_[0] = s0;
+    stage_[1] = s1;
+    stage_[2] = s2;
+    stage_[3] = s3;
+    g_ = g;
+    rampSamples_ -= rampLen;
+    if (rampLen > 0 && rampSamples_ == 0)
+      g_ = gTarget_;
+  }
+
+  static Sample softClip(Sample x) { return Saturator::process(x); }
 };
 
+using LadderFilter = BasicLadderFilter<TanhPade>;
+
 } // namespace synth
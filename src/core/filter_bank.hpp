@@ -0,0 +1,314 @@
+#pragma once
+/**
+ * @file filter_bank.hpp
+ * @brief Filters for many voices at once, one voice per SIMD lane
+ *
+ * StateVariableFilter and LadderFilter each carry one voice's state and
+ * coefficients, so N voices run N serial recursions one after another.
+ * The recursions of different voices are independent, though: FilterBank
+ * stores them structure-of-arrays (low[N], band[N], f[N], ...) and steps
+ * SIMD_WIDTH voices per Float4 operation, so a group of four costs about
+ * what one scalar filter does.
+ *
+ * Two models, matching the scalar filters in single precision:
+ * - SVF: Chamberlin state variable, two iterations per sample, with the
+ *   StateVariableFilter drive stages (RationalClip); all FilterMode
+ *   outputs
+ * - LADDER: four one-pole stages with TanhPade saturation and feedback,
+ *   as LadderFilter, low-pass only
+ *
+ * Resonance, drive and mode are patch parameters shared by every voice;
+ * the cutoff coefficient and all state are per voice. The bank runs at
+ * the rate it is prepared for: there is no oversampling, as in
+ * SimdSynthEngine.
+ */
+
+#include "cutoff_table.hpp"
+#include "saturator.hpp"
+#include "simd.hpp"
+#include "types.hpp"
+#include <algorithm>
+#include <cmath>
+
+namespace synth {
+
+/**
+ * @class FilterBank
+ * @brief SoA state and coefficients for NumVoices filters of one model
+ * @tparam NumVoices Voices in the bank, a multiple of SIMD_WIDTH
+ */
+template <int NumVoices> class FilterBank {
+  static_assert(NumVoices > 0 && NumVoices % SIMD_WIDTH == 0,
+                "FilterBank voices must fill whole SIMD groups");
+
+public:
+  /** @brief Float4 groups per sample in a processBlock() buffer */
+  static constexpr int GROUPS = NumVoices / SIMD_WIDTH;
+
+  FilterBank() {
+    setResonance(0.0);
+    // Closed until the first ramp opens it
+    for (int v = 0; v < NumVoices; ++v) {
+      pitch_[v] = MIN_CUTOFF_PITCH;
+      coef_[v] = coefTarget_[v] = coefStep_[v] = 0.0f;
+      reset(v);
+    }
+  }
+
+  /**
+   * @brief Set the sample rate (call before processing, not on the
+   *        audio thread: the coefficient table may be built here)
+   * @param sampleRate Sample rate in Hz
+   */
+  void prepare(double sampleRate) {
+    table_ = &CutoffTable::forRate(sampleRate);
+    ladderMaxPitch_ = cutoffToPitch(sampleRate * 0.5 * 0.45);
+  }
+
+  /**
+   * @brief Select the model; a change clears every voice
+   *
+   * ZDF has no bank form and runs as SVF. The coefficients switch curve
+   * at the voices' current cutoffs, so no ramp spans two models.
+   */
+  void setType(FilterType type) {
+    type = (type == FilterType::LADDER) ? FilterType::LADDER : FilterType::SVF;
+    if (type == type_)
+      return;
+    type_ = type;
+    for (int v = 0; v < NumVoices; ++v) {
+      coef_[v] = coefTarget_[v] = coefficient(pitch_[v]);
+      coefStep_[v] = 0.0f;
+      reset(v);
+    }
+  }
+
+  FilterType getType() const { return type_; }
+
+  /**
+   * @brief Set resonance for every voice
+   * @param res Resonance amount (0.0 to 1.0)
+   */
+  void setResonance(Parameter res) {
+    q_ = static_cast<float>(2.0 - 2.0 * std::clamp(res, 0.0, 0.99));
+    // Chamberlin stability bound, as in StateVariableFilter
+    fMax_ = 0.9 * (std::sqrt(q_ * q_ + 4.0) - q_);
+    k_ = static_cast<float>(4.0 * std::clamp(res, 0.0, 1.0));
+  }
+
+  /**
+   * @brief Set drive for every voice
+   * @param drv Drive amount (0.0 = clean, 1.0 = heavy saturation)
+   */
+  void setDrive(Parameter drv) {
+    drive_ = static_cast<float>(std::clamp(drv, 0.0, 1.0));
+  }
+
+  /**
+   * @brief Set the SVF output; the ladder is always low-pass
+   */
+  void setMode(FilterMode m) { mode_ = m; }
+
+  /**
+   * @brief Clear one voice's state (on note-on)
+   */
+  void reset(int voice) {
+    low_[voice] = band_[voice] = 0.0f;
+    for (auto &stage : stage_)
+      stage[voice] = 0.0f;
+  }
+
+  /**
+   * @brief Glide every voice's cutoff to a new value over the next block
+   *
+   * The coefficient is looked up once per voice here and interpolated
+   * linearly by processBlock(), as the scalar filters' rampCutoff().
+   *
+   * @param pitch Target cutoff per voice, log2(Hz) (NumVoices long)
+   * @param numSamples Length of the next processBlock()
+   */
+  void rampCutoffPitch(const double *pitch, int numSamples) {
+    alignas(16) float target[NumVoices];
+    for (int v = 0; v < NumVoices; ++v) {
+      pitch_[v] = pitch[v];
+      target[v] = coefficient(pitch[v]);
+    }
+
+    const Float4 invLen = 1.0f / static_cast<float>(std::max(numSamples, 1));
+    for (int g = 0; g < NumVoices; g += SIMD_WIDTH) {
+      const Float4 c = Float4::load(coef_ + g);
+      ((Float4::load(target + g) - c) * invLen).store(coefStep_ + g);
+    }
+    std::copy(target, target + NumVoices, coefTarget_);
+  }
+
+  /**
+   * @brief Filter a block of every voice, fused with its producer and
+   *        consumer
+   *
+   * For each sample i, for each group g in turn: x = input(i, g), then
+   * output(i, g, y) with the filtered y. Inlining both into the filter
+   * loop lets their work overlap the filter's recursion latency. Ends any
+   * cutoff ramp exactly on its target.
+   *
+   * @param numSamples Number of samples
+   * @param input Callable (int i, int g) -> Float4, voices 4g..4g+3
+   * @param output Callable (int i, int g, Float4 y)
+   */
+  template <typename Input, typename Output>
+  void process(int numSamples, Input &&input, Output &&output) {
+    if (type_ == FilterType::LADDER) {
+      processLadder(numSamples, input, output);
+    } else {
+      switch (mode_) {
+      case FilterMode::HIGHPASS:
+        processSvf<FilterMode::HIGHPASS>(numSamples, input, output);
+        break;
+      case FilterMode::BANDPASS:
+        processSvf<FilterMode::BANDPASS>(numSamples, input, output);
+        break;
+      case FilterMode::NOTCH:
+        processSvf<FilterMode::NOTCH>(numSamples, input, output);
+        break;
+      case FilterMode::LOWPASS:
+      default:
+        processSvf<FilterMode::LOWPASS>(numSamples, input, output);
+        break;
+      }
+    }
+    std::copy(coefTarget_, coefTarget_ + NumVoices, coef_);
+    std::fill(coefStep_, coefStep_ + NumVoices, 0.0f);
+  }
+
+  /**
+   * @brief Filter a block of every voice in place
+   * @param buffer numSamples * GROUPS Float4s; buffer[i * GROUPS + g]
+   *        holds sample i of voices 4g..4g+3
+   * @param numSamples Number of samples
+   */
+  void processBlock(Float4 *buffer, int numSamples) {
+    process(
+        numSamples,
+        [buffer](int i, int g) { return buffer[i * GROUPS + g]; },
+        [buffer](int i, int g, Float4 y) { buffer[i * GROUPS + g] = y; });
+  }
+
+private:
+  FilterType type_ = FilterType::SVF;
+  FilterMode mode_ = FilterMode::LOWPASS;
+  float q_ = 2.0f;
+  double fMax_ = 0.0; // Largest stable SVF f for q_
+  float k_ = 0.0f;    // Ladder feedback
+  float drive_ = 0.0f;
+
+  // Per-voice cutoff, log2(Hz), and its coefficient (SVF f or ladder g)
+  // with the ramp towards it
+  double pitch_[NumVoices];
+  alignas(16) float coef_[NumVoices];
+  alignas(16) float coefStep_[NumVoices];
+  alignas(16) float coefTarget_[NumVoices];
+
+  // SVF state
+  alignas(16) float low_[NumVoices];
+  alignas(16) float band_[NumVoices];
+
+  // Ladder state, one array per stage
+  alignas(16) float stage_[4][NumVoices];
+
+  const CutoffTable *table_ = &CutoffTable::forRate(DEFAULT_SAMPLE_RATE);
+  double ladderMaxPitch_ = cutoffToPitch(DEFAULT_SAMPLE_RATE * 0.5 * 0.45);
+
+  float coefficient(double pitch) const {
+    if (type_ == FilterType::LADDER)
+      return static_cast<float>(table_->lookup(
+          CutoffCurve::LADDER, std::min(pitch, ladderMaxPitch_)));
+    return static_cast<float>(
+        std::min(table_->lookup(CutoffCurve::CHAMBERLIN, pitch), fMax_));
+  }
+
+  // The kernels keep every group's state in registers for the block.
+  // Groups interleave inside the sample loop: each one's recursion is a
+  // serial chain (the ladder's of divisions), and the others fill its
+  // latency.
+
+  template <FilterMode Mode, typename Input, typename Output>
+  void processSvf(int n, Input &input, Output &output) {
+    const Float4 q = q_;
+    const Float4 driveGain = 1.0f + drive_ * 3.0f;
+    const bool driveIn = drive_ > 0.0f;
+    const bool driveOut = drive_ > 0.5f;
+
+    Float4 f[GROUPS], fStep[GROUPS], low[GROUPS], band[GROUPS];
+    for (int g = 0; g < GROUPS; ++g) {
+      const int lane = g * SIMD_WIDTH;
+      f[g] = Float4::load(coef_ + lane);
+      fStep[g] = Float4::load(coefStep_ + lane);
+      low[g] = Float4::load(low_ + lane);
+      band[g] = Float4::load(band_ + lane);
+    }
+
+    for (int i = 0; i < n; ++i) {
+      for (int g = 0; g < GROUPS; ++g) {
+        Float4 x = input(i, g);
+        if (driveIn)
+          x = softClip(x * driveGain);
+
+        f[g] += fStep[g];
+        Float4 high;
+        for (int k = 0; k < 2; ++k) {
+          low[g] += f[g] * band[g];
+          high = x - low[g] - q * band[g];
+          band[g] += f[g] * high;
+        }
+
+        Float4 y = (Mode == FilterMode::HIGHPASS)   ? high
+                   : (Mode == FilterMode::BANDPASS) ? band[g]
+                   : (Mode == FilterMode::NOTCH)    ? low[g] + high
+                                                    : low[g];
+        output(i, g, driveOut ? softClip(y) : y);
+      }
+    }
+
+    for (int g = 0; g < GROUPS; ++g) {
+      low[g].store(low_ + g * SIMD_WIDTH);
+      band[g].store(band_ + g * SIMD_WIDTH);
+    }
+  }
+
+  template <typename Input, typename Output>
+  void processLadder(int n, Input &input, Output &output) {
+    const Float4 k = k_;
+    const Float4 inputGain = 1.0f + drive_ * 3.0f;
+
+    Float4 c[GROUPS], cStep[GROUPS], s[4][GROUPS];
+    for (int g = 0; g < GROUPS; ++g) {
+      const int lane = g * SIMD_WIDTH;
+      c[g] = Float4::load(coef_ + lane);
+      cStep[g] = Float4::load(coefStep_ + lane);
+      for (int j = 0; j < 4; ++j)
+        s[j][g] = Float4::load(stage_[j] + lane);
+    }
+
+    for (int i = 0; i < n; ++i) {
+      for (int g = 0; g < GROUPS; ++g) {
+        c[g] += cStep[g];
+        const Float4 x =
+            TanhPade::process(input(i, g) * inputGain - s[3][g] * k);
+        s[0][g] += c[g] * (TanhPade::process(x) - s[0][g]);
+        s[1][g] += c[g] * (TanhPade::process(s[0][g]) - s[1][g]);
+        s[2][g] += c[g] * (TanhPade::process(s[1][g]) - s[2][g]);
+        s[3][g] += c[g] * (TanhPade::process(s[2][g]) - s[3][g]);
+        output(i, g, s[3][g]);
+      }
+    }
+
+    for (int g = 0; g < GROUPS; ++g)
+      for (int j = 0; j < 4; ++j)
+        s[j][g].store(stage_[j] + g * SIMD_WIDTH);
+  }
+
+  // SVF drive curve, as in StateVariableFilter
+  static Float4 softClip(Float4 x) { return RationalClip::process(x); }
+};
+
+} // namespace synth
@@ -0,0 +1,391 @@
+#pragma once
+/**
+ * @file fm_engine.hpp
+ * @brief 4-operator FM engine (MultiEngine VPM mode)
+ *
+ * Four sine operators with per-operator ratio, level and ADSR, wired by
+ * one of eight algorithms (the classic 4-op set: stacks, branches and
+ * parallel carriers). Operator 4 has self-feedback.
+ *
+ * The render kernel is a template over the lane type:
+ * - Sample: one voice, used by FmEngine inside every Voice
+ * - Float4: one voice per SIMD lane, used by SimdSynthEngine
+ *
+ * Both share the wavetable sine and the algorithm tables, and envelopes
+ * run at control rate with per-sample gain ramps, so one code path
+ * describes the FPGA operator pipeline for any number of voices.
+ */
+
+#include "envelope.hpp"
+#include "simd.hpp"
+#include "types.hpp"
+#include "wavetable.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+
+namespace synth {
+
+constexpr int FM_OPERATORS = 4;
+constexpr int FM_NUM_ALGORITHMS = 8;
+
+// Peak modulation of a full-level modulator, in cycles (4*pi radians)
+constexpr double FM_MAX_MOD_CYCLES = 2.0;
+// Self-feedback at full setting, in cycles per unit of averaged output
+constexpr double FM_MAX_FEEDBACK_CYCLES = 0.25;
+
+/**
+ * @struct FmAlgorithm
+ * @brief Operator routing: who modulates whom, and who is heard
+ *
+ * Operators are numbered 0..3 (OP1..OP4). Modulators always have a higher
+ * index than the operator they modulate, so evaluating from OP4 down to
+ * OP1 sees every modulator output of the current sample.
+ */
+struct FmAlgorithm {
+  uint8_t modulators[FM_OPERATORS]; // Bit m set: OP(m+1) modulates this op
+  uint8_t carriers;                 // Bit k set: OP(k+1) goes to the output
+};
+
+inline constexpr FmAlgorithm FM_ALGORITHMS[FM_NUM_ALGORITHMS] = {
+    {{0x2, 0x4, 0x8, 0x0}, 0x1}, // 1: 4 > 3 > 2 > 1
+    {{0x2, 0xC, 0x0, 0x0}, 0x1}, // 2: (3 + 4) > 2 > 1
+    {{0xA, 0x4, 0x0, 0x0}, 0x1}, // 3: (3 > 2) + 4 > 1
+    {{0x6, 0x0, 0x8, 0x0}, 0x1}, // 4: 2 + (4 > 3) > 1
+    {{0x2, 0x0, 0x8, 0x0}, 0x5}, // 5: (2 > 1) + (4 > 3)
+    {{0x8, 0x8, 0x8, 0x0}, 0x7}, // 6: 4 > each of 1, 2, 3
+    {{0x0, 0x0, 0x8, 0x0}, 0x7}, // 7: 1 + 2 + (4 > 3)
+    {{0x0, 0x0, 0x0, 0x0}, 0xF}  // 8: 1 + 2 + 3 + 4
+};
+
+/**
+ * @struct FmOperatorParams
+ * @brief Settings for one operator
+ */
+struct FmOperatorParams {
+  Parameter ratio = 1.0; // Frequency multiple of the note
+  Parameter level = 0.0; // Output level (carrier) or depth (modulator)
+  double attack = 0.001;
+  double decay = 0.5;
+  Parameter sustain = 1.0;
+  double release = 0.3;
+};
+
+/**
+ * @struct FmPatch
+ * @brief Complete FM voice settings (stored in SynthPreset)
+ */
+struct FmPatch {
+  int algorithm = 0;        // 0..FM_NUM_ALGORITHMS-1
+  Parameter feedback = 0.0; // OP4 self-feedback (0 to 1)
+  FmOperatorParams op[FM_OPERATORS];
+
+  FmPatch() {
+    // Plain 2-operator FM: OP2 modulates OP1
+    op[0].level = 1.0;
+    op[1].level = 0.125;
+  }
+};
+
+// =============================================================================
+// Lane-generic Kernel
+// =============================================================================
+
+/**
+ * @struct FmLanes
+ * @brief Audio-rate operator state for one voice (Sample) or four (Float4)
+ */
+template <typename T> struct FmLanes {
+  T phase[FM_OPERATORS];
+  T increment[FM_OPERATORS];
+  T gain[FM_OPERATORS];     // Envelope x level x role scale
+  T gainStep[FM_OPERATORS]; // Per-sample ramp to the next control value
+  T feedback;               // Cycles per unit of averaged OP4 output
+  T history[2];             // Last two raw OP4 outputs
+
+  FmLanes() { reset(); }
+
+  void reset() {
+    for (int k = 0; k < FM_OPERATORS; ++k)
+      phase[k] = increment[k] = gain[k] = gainStep[k] = T(0.0f);
+    feedback = history[0] = history[1] = T(0.0f);
+  }
+};
+
+/**
+ * @brief sin(2*pi*phase) from the shared table, for any phase
+ *
+ * The scalar path floors once and masks the table index, so modulated
+ * phases never need a separate wrap.
+ */
+inline Sample fmSine(const float *sine, Sample phase) {
+  Sample pos = phase * WAVETABLE_SIZE;
+  int64_t index = static_cast<int64_t>(pos); // std::floor is a libm call
+  Sample base = static_cast<Sample>(index);
+  if (pos < base) {
+    index -= 1;
+    base -= 1.0;
+  }
+  const float *t = sine + (index & (WAVETABLE_SIZE - 1));
+  return t[0] + (pos - base) * (t[1] - t[0]);
+}
+
+inline Float4 fmSine(const float *sine, Float4 phase) {
+  return tableLookup(sine, (phase - floor(phase)) *
+                               static_cast<float>(WAVETABLE_SIZE));
+}
+
+/**
+ * @brief Advance a phase in [0, 1) by one increment
+ */
+inline Sample fmAdvance(Sample phase, Sample increment) {
+  phase += increment;
+  return phase >= 1.0 ? phase - 1.0 : phase;
+}
+
+inline Float4 fmAdvance(Float4 phase, Float4 increment) {
+  return wrapPhase(phase + increment);
+}
+
+namespace detail {
+
+// Sum op[M] for every modulator M of operator K (unrolled at compile time)
+template <int Algorithm, int K, int M, typename T>
+inline void addModulators(T &phase, const T *op) {
+  if constexpr (M < FM_OPERATORS) {
+    if constexpr ((FM_ALGORITHMS[Algorithm].modulators[K] >> M) & 1)
+      phase += op[M];
+    addModulators<Algorithm, K, M + 1>(phase, op);
+  }
+}
+
+// Evaluate operators K, K-1, ..., 0 for one sample
+template <int Algorithm, int K, typename T>
+inline void evalOperators(FmLanes<T> &v, const float *sine, T *op) {
+  T phase = v.phase[K];
+  if constexpr (K == FM_OPERATORS - 1)
+    phase += v.feedback * (v.history[0] + v.history[1]);
+  addModulators<Algorithm, K, K + 1>(phase, op);
+
+  T raw = fmSine(sine, phase);
+  if constexpr (K == FM_OPERATORS - 1) {
+    v.history[1] = v.history[0];
+    v.history[0] = raw;
+  }
+  v.gain[K] += v.gainStep[K];
+  op[K] = raw * v.gain[K];
+
+  if constexpr (K > 0)
+    evalOperators<Algorithm, K - 1>(v, sine, op);
+}
+
+// Sum of the carrier outputs
+template <int Algorithm, int K, typename T>
+inline T sumCarriers(const T *op) {
+  if constexpr (K == FM_OPERATORS) {
+    return T(0.0f);
+  } else if constexpr ((FM_ALGORITHMS[Algorithm].carriers >> K) & 1) {
+    return op[K] + sumCarriers<Algorithm, K + 1>(op);
+  } else {
+    return sumCarriers<Algorithm, K + 1>(op);
+  }
+}
+
+} // namespace detail
+
+/**
+ * @brief Render numSamples of one algorithm
+ *
+ * Carrier outputs are summed into out; gains ramp by gainStep per sample.
+ * The routing is resolved at compile time, so each algorithm is a
+ * straight-line loop.
+ */
+template <typename T, int Algorithm>
+void renderFm(FmLanes<T> &s, const float *sine, T *out, int numSamples) {
+  // Work on a local copy so stores to out cannot alias the state
+  FmLanes<T> v = s;
+  for (int i = 0; i < numSamples; ++i) {
+    T op[FM_OPERATORS];
+    detail::evalOperators<Algorithm, FM_OPERATORS - 1>(v, sine, op);
+    out[i] = detail::sumCarriers<Algorithm, 0>(op);
+    for (int k = 0; k < FM_OPERATORS; ++k)
+      v.phase[k] = fmAdvance(v.phase[k], v.increment[k]);
+  }
+  s = v;
+}
+
+/**
+ * @brief Kernel for an algorithm index (picked at control rate)
+ */
+template <typename T>
+using FmKernel = void (*)(FmLanes<T> &, const float *, T *, int);
+
+template <typename T> FmKernel<T> fmKernel(int algorithm) {
+  static const FmKernel<T> kernels[FM_NUM_ALGORITHMS] = {
+      &renderFm<T, 0>, &renderFm<T, 1>, &renderFm<T, 2>, &renderFm<T, 3>,
+      &renderFm<T, 4>, &renderFm<T, 5>, &renderFm<T, 6>, &renderFm<T, 7>};
+  return kernels[std::clamp(algorithm, 0, FM_NUM_ALGORITHMS - 1)];
+}
+
+/**
+ * @brief Gain scale per operator: carriers share the output, modulators
+ *        map level to phase deviation in cycles
+ * @param depth Global modulation depth (0 to 1)
+ */
+inline void fmOperatorScales(const FmPatch &patch, Parameter depth,
+                             double scale[FM_OPERATORS]) {
+  const FmAlgorithm &alg =
+      FM_ALGORITHMS[std::clamp(patch.algorithm, 0, FM_NUM_ALGORITHMS - 1)];
+  int carriers = 0;
+  for (int k = 0; k < FM_OPERATORS; ++k)
+    carriers += (alg.carriers >> k) & 1;
+  for (int k = 0; k < FM_OPERATORS; ++k)
+    scale[k] = patch.op[k].level *
+               ((alg.carriers & (1 << k)) ? 1.0 / carriers
+                                          : FM_MAX_MOD_CYCLES * depth);
+}
+
+// =============================================================================
+// Single-voice FM Engine
+// =============================================================================
+
+/**
+ * @class FmEngine
+ * @brief One voice of 4-operator FM with per-operator envelopes
+ */
+class FmEngine {
+public:
+  FmEngine() : sine_(WavetableBank::instance().sine()) { setPatch(patch_); }
+
+  void prepare(double sampleRate) {
+    sampleRate_ = sampleRate;
+    for (auto &env : env_)
+      env.prepare(sampleRate);
+    setFrequency(frequency_);
+  }
+
+  void setFrequency(Frequency freq) {
+    frequency_ = freq;
+    for (int k = 0; k < FM_OPERATORS; ++k)
+      lanes_.increment[k] = frequencyToPhaseIncrement(
+          freq * patch_.op[k].ratio, sampleRate_);
+  }
+
+  /**
+   * @brief Load every operator setting at once
+   */
+  void setPatch(const FmPatch &patch) {
+    patch_ = patch;
+    patch_.algorithm = std::clamp(patch.algorithm, 0, FM_NUM_ALGORITHMS - 1);
+    for (int k = 0; k < FM_OPERATORS; ++k) {
+      const FmOperatorParams &op = patch_.op[k];
+      env_[k].setAttack(op.attack);
+      env_[k].setDecay(op.decay);
+      env_[k].setSustain(op.sustain);
+      env_[k].setRelease(op.release);
+    }
+    setFeedback(patch_.feedback);
+    update();
+  }
+
+  const FmPatch &getPatch() const { return patch_; }
+
+  void setAlgorithm(int algorithm) {
+    patch_.algorithm = std::clamp(algorithm, 0, FM_NUM_ALGORITHMS - 1);
+    update();
+  }
+
+  /**
+   * @brief Per-operator settings; an op outside [0, FM_OPERATORS) is
+   *        ignored
+   */
+  void setOperatorRatio(int op, Parameter ratio) {
+    if (op < 0 || op >= FM_OPERATORS)
+      return;
+    patch_.op[op].ratio = std::clamp(ratio, 0.125, 32.0);
+    update();
+  }
+
+  void setOperatorLevel(int op, Parameter level) {
+    if (op < 0 || op >= FM_OPERATORS)
+      return;
+    patch_.op[op].level = std::clamp(level, 0.0, 1.0);
+    update();
+  }
+
+  void setFeedback(Parameter amount) {
+    patch_.feedback = std::clamp(amount, 0.0, 1.0);
+    lanes_.feedback = patch_.feedback * FM_MAX_FEEDBACK_CYCLES * 0.5;
+  }
+
+  /**
+   * @brief Scale every modulator at once (brightness, 0 to 1)
+   */
+  void setModulationDepth(Parameter depth) {
+    depth_ = std::clamp(depth, 0.0, 1.0);
+    update();
+  }
+
+  void noteOn() {
+    for (int k = 0; k < FM_OPERATORS; ++k) {
+      lanes_.phase[k] = 0.0;
+      env_[k].noteOn();
+    }
+    lanes_.history[0] = lanes_.history[1] = 0.0;
+  }
+
+  void noteOff() {
+    for (auto &env : env_)
+      env.noteOff();
+  }
+
+  Sample process() {
+    Sample output;
+    processBlock(&output, 1);
+    return output;
+  }
+
+  /**
+   * @brief Render a block; envelopes step once per CONTROL_BLOCK_SIZE
+   *        samples no matter how the block is split
+   */
+  void processBlock(Sample *out, int numSamples) {
+    while (numSamples > 0) {
+      if (controlRemaining_ == 0)
+        startControlBlock();
+      int len = std::min(numSamples, controlRemaining_);
+      kernel_(lanes_, sine_, out, len);
+      out += len;
+      numSamples -= len;
+      controlRemaining_ -= len;
+    }
+  }
+
+private:
+  FmPatch patch_;
+  FmLanes<Sample> lanes_;
+  FmKernel<Sample> kernel_ = nullptr;
+  ADSR env_[FM_OPERATORS];
+  double scale_[FM_OPERATORS] = {};
+  Parameter depth_ = 1.0;
+  const float *sine_;
+  int controlRemaining_ = 0;
+  double sampleRate_ = DEFAULT_SAMPLE_RATE;
+  Frequency frequency_ = 0.0;
+
+  void update() {
+    kernel_ = fmKernel<Sample>(patch_.algorithm);
+    fmOperatorScales(patch_, depth_, scale_);
+    setFrequency(frequency_);
+  }
+
+  void startControlBlock() {
+    for (int k = 0; k < FM_OPERATORS; ++k) {
+      Sample target = env_[k].advance(CONTROL_BLOCK_SIZE) * scale_[k];
+      lanes_.gainStep[k] = (target - lanes_.gain[k]) / CONTROL_BLOCK_SIZE;
+    }
+    controlRemaining_ = CONTROL_BLOCK_SIZE;
+  }
+};
+
+} // namespace synth
@@ -10,9 +10,10 @@
  * - Shape control
  */
 
+#include "noise.hpp"
 #include "types.hpp"
+#include "wavetable.hpp"
 #include <algorithm>
-#include <random>
 
 namespace synth {
 
@@ -26,9 +27,17 @@ public:
 
   LFO()
       : phase_(0.0), rate_(1.0), shape_(Shape::TRIANGLE),
-        phaseIncrement_(1.0 / SAMPLE_RATE), lastOutput_(0.0),
-        sampleHoldValue_(0.0), rng_(std::random_device{}()),
-        randomDist_(-1.0, 1.0) {}
+        phaseIncrement_(1.0 / DEFAULT_SAMPLE_RATE), lastOutput_(0.0),
+        sampleHoldValue_(0.0) {}
+
+  /**
+   * @brief Set the sample rate (call before processing)
+   * @param sampleRate Sample rate in Hz
+   */
+  void prepare(double sampleRate) {
+    sampleRate_ = sampleRate;
+    setRate(rate_);
+  }
 
   /**
    * @brief Set LFO rate
@@ -36,7 +45,7 @@ public:
    */
   void setRate(Frequency hz) {
     rate_ = std::clamp(hz, 0.01, 100.0);
-    phaseIncrement_ = rate_ / SAMPLE_RATE;
+    phaseIncrement_ = rate_ / sampleRate_;
   }
 
   /**
@@ -59,21 +68,63 @@ public:
    */
   void sync() { phase_ = 0.0; }
 
+  /**
+   * @brief Restart the sample & hold sequence (for reproducible renders)
+   */
+  void seedNoise(uint32_t seed) { random_.seed(seed); }
+
   /**
    * @brief Process one sample
    * @return LFO output (-1.0 to 1.0)
    */
-  Sample process() {
+  Sample process() { return step(phaseIncrement_); }
+
+  /**
+   * @brief Advance by several samples and evaluate once (control rate)
+   * @param numSamples Samples to advance (normally CONTROL_BLOCK_SIZE)
+   * @return LFO output at the end of the step (-1.0 to 1.0)
+   */
+  Sample advance(int numSamples) { return step(phaseIncrement_ * numSamples); }
+
+  /**
+   * @brief Render a block of LFO values
+   * @param out Output buffer (numSamples long)
+   * @param numSamples Number of samples to render
+   */
+  void processBlock(Sample *out, int numSamples) {
+    for (int i = 0; i < numSamples; ++i) {
+      out[i] = process();
+    }
+  }
+
+  /**
+   * @brief Get unipolar output
+   * @return LFO output (0.0 to 1.0)
+   */
+  Sample processUnipolar() { return (process() + 1.0) * 0.5; }
+
+private:
+  Phase phase_;
+  Frequency rate_;
+  Shape shape_;
+  Phase phaseIncrement_;
+  Sample lastOutput_;
+  Sample sampleHoldValue_;
+  double sampleRate_ = DEFAULT_SAMPLE_RATE;
+  NoiseGenerator random_;
+  const float *sineTable_ = WavetableBank::instance().sine();
+
+  Sample step(Phase increment) {
     Sample output = 0.0;
     Phase prevPhase = phase_;
 
-    phase_ += phaseIncrement_;
+    phase_ += increment;
     if (phase_ >= 1.0)
-      phase_ -= 1.0;
+      phase_ -= std::floor(phase_);
 
     switch (shape_) {
     case Shape::SINE:
-      output = std::sin(TWO_PI * phase_);
+      output = readLinear(sineTable_, phase_);
       break;
     case Shape::TRIANGLE:
       output = (phase_ < 0.5) ? (4.0 * phase_ - 1.0) : (3.0 - 4.0 * phase_);
@@ -89,7 +140,7 @@ public:
       break;
     case Shape::SAMPLE_HOLD:
       if (phase_ < prevPhase)
-        sampleHoldValue_ = randomDist_(rng_);
+        sampleHoldValue_ = random_.next();
       output = sampleHoldValue_;
       break;
     }
@@ -97,22 +148,6 @@ public:
     lastOutput_ = output;
     return output;
   }
-
-  /**
-   * @brief Get unipolar output
-   * @return LFO output (0.0 to 1.0)
-   */
-  Sample processUnipolar() { return (process() + 1.0) * 0.5; }
-
-private:
-  Phase phase_;
-  Frequency rate_;
-  Shape shape_;
-  Phase phaseIncrement_;
-  Sample lastOutput_;
-  Sample sampleHoldValue_;
-  std::mt19937 rng_;
-  std::uniform_real_distribution<double> randomDist_;
 };
 
 } // namespace synth
@@ -6,12 +6,21 @@
  * Implements VCO1 and VCO2 from Minilogue XD:
  * - Saw, Triangle, Square waveforms
  * - Pulse Width Modulation
- * - Hard sync capability
+ * - Band-limited hard sync and cross modulation (MixingOscillator)
  * - PolyBLEP for alias-free output at 192kHz
+ *
+ * Sine (and MixingOscillator's saw, triangle and square) come from the
+ * shared band-limited wavetables in wavetable.hpp instead of libm.
  */
 
+#include "additive.hpp"
+#include "fm_engine.hpp"
+#include "noise.hpp"
 #include "types.hpp"
-#include <random>
+#include "wavetable.hpp"
+#include <algorithm>
+#include <array>
+#include <utility>
 
 namespace synth {
 
@@ -26,15 +35,24 @@ class Oscillator {
 public:
   Oscillator()
       : phase_(0.0), phaseIncrement_(0.0), waveform_(Waveform::SAW),
-        pulseWidth_(0.5), lastOutput_(0.0), rng_(std::random_device{}()),
-        noiseDist_(-1.0, 1.0) {}
+        pulseWidth_(0.5), lastOutput_(0.0) {}
+
+  /**
+   * @brief Set the sample rate (call before processing)
+   * @param sampleRate Sample rate in Hz
+   */
+  void prepare(double sampleRate) {
+    sampleRate_ = sampleRate;
+    setFrequency(frequency_);
+  }
 
   /**
    * @brief Set oscillator frequency
    * @param freq Frequency in Hz
    */
   void setFrequency(Frequency freq) {
-    phaseIncrement_ = frequencyToPhaseIncrement(freq);
+    frequency_ = freq;
+    phaseIncrement_ = frequencyToPhaseIncrement(freq, sampleRate_);
   }
 
   /**
@@ -59,6 +77,11 @@ public:
    */
   void sync() { phase_ = 0.0; }
 
+  /**
+   * @brief Restart the noise stream (for reproducible renders)
+   */
+  void seedNoise(uint32_t seed) { noise_.seed(seed); }
+
   /**
    * @brief Process one sample
    * @return Output sample (-1.0 to 1.0)
@@ -94,6 +117,17 @@ public:
     return output;
   }
 
+  /**
+   * @brief Render a block of samples
+   * @param out Output buffer (numSamples long)
+   * @param numSamples Number of samples to render
+   */
+  void processBlock(Sample *out, int numSamples) {
+    for (int i = 0; i < numSamples; ++i) {
+      out[i] = process();
+    }
+  }
+
   /**
    * @brief Get current phase (for sync)
    */
@@ -105,10 +139,11 @@ private:
   Waveform waveform_;
   Parameter pulseWidth_;
   Sample lastOutput_;
+  double sampleRate_ = DEFAULT_SAMPLE_RATE;
+  Frequency frequency_ = 0.0;
+  const float *sineTable_ = WavetableBank::instance().sine();
 
-  // For noise generation
-  std::mt19937 rng_;
-  std::uniform_real_distribution<double> noiseDist_;
+  NoiseGenerator noise_;
 
   /**
    * @brief PolyBLEP correction for discontinuities
@@ -131,7 +166,7 @@ private:
     return 0.0;
   }
 
-  Sample processSine() const { return std::sin(TWO_PI * phase_); }
+  Sample processSine() const { return readLinear(sineTable_, phase_); }
 
   Sample processSaw() {
     // Naive saw: 2 * phase - 1
@@ -166,10 +201,7 @@ private:
     return square;
   }
 
-  Sample processNoise() {
-    // White noise (LFSR would be better for FPGA)
-    return noiseDist_(rng_);
-  }
+  Sample processNoise() { return noise_.next(); }
 };
 
 /**
@@ -196,6 +228,18 @@ struct WaveMix {
   }
 };
 
+/**
+ * @struct OscModulation
+ * @brief How a master oscillator drives a MixingOscillator for one block
+ */
+struct OscModulation {
+  bool sync = false;            // Hard sync the slave to the master
+  Phase masterPhase = 0.0;      // Master phase at the block's first sample
+  Phase masterIncrement = 0.0;  // Master phase increment per sample
+  const Sample *cross = nullptr; // Master output (block long), or null
+  Parameter crossDepth = 0.0;    // Linear FM depth (1 = +-100% of pitch)
+};
+
 /**
  * @class MixingOscillator
  * @brief Oscillator that blends multiple waveforms simultaneously
@@ -203,17 +247,41 @@ struct WaveMix {
  * Unlike the standard Oscillator which switches between waveforms,
  * this generates all waveforms and mixes them according to WaveMix levels.
  * Perfect for creating complex timbres and drum sounds.
+ *
+ * Every tonal waveform is a lookup into the mipmapped wavetables, with the
+ * mip level picked in setFrequency(), so high notes stay alias-free
+ * without per-sample PolyBLEP.
+ *
+ * Each combination of active waveforms (a 5-bit mask, 32 in all) has its
+ * own block kernel generated from one template. Changing the mix selects
+ * the kernel and folds the normalization into per-wave gains, so the
+ * inner loop only computes the waves that are audible and never divides.
+ *
+ * As a slave (see OscModulation) the phase can be hard-synced to a master
+ * and its frequency modulated by the master's output. Sync resets are
+ * band-limited: the slave tracks the master's phase itself, so it knows
+ * the fractional reset time one sample ahead and spreads a PolyBLEP
+ * residual over the samples on both sides of the jump, across block
+ * boundaries too. Slope kinks are left uncorrected (no BLAMP).
  */
 class MixingOscillator {
 public:
   MixingOscillator()
-      : phase_(0.0), phaseIncrement_(0.0), pulseWidth_(0.5),
-        rng_(std::random_device{}()), noiseDist_(-1.0, 1.0) {
+      : phase_(0.0), phaseIncrement_(0.0), pulseWidth_(0.5) {
     mix_.sawtooth = 1.0; // Default to pure saw
+    updateTables();
+    updateKernel();
+  }
+
+  void prepare(double sampleRate) {
+    sampleRate_ = sampleRate;
+    setFrequency(frequency_);
   }
 
   void setFrequency(Frequency freq) {
-    phaseIncrement_ = frequencyToPhaseIncrement(freq);
+    frequency_ = freq;
+    phaseIncrement_ = frequencyToPhaseIncrement(freq, sampleRate_);
+    updateTables();
   }
 
   void setNote(int note) { setFrequency(midiToFrequency(note)); }
@@ -222,27 +290,24 @@ public:
 
   void sync() { phase_ = 0.0; }
 
+  void seedNoise(uint32_t seed) { noise_.seed(seed); }
+
   /**
    * @brief Set individual waveform mix levels
    */
-  void setSineMix(Parameter level) { mix_.sine = std::clamp(level, 0.0, 1.0); }
-  void setTriangleMix(Parameter level) {
-    mix_.triangle = std::clamp(level, 0.0, 1.0);
-  }
-  void setSawtoothMix(Parameter level) {
-    mix_.sawtooth = std::clamp(level, 0.0, 1.0);
-  }
-  void setSquareMix(Parameter level) {
-    mix_.square = std::clamp(level, 0.0, 1.0);
-  }
-  void setNoiseMix(Parameter level) {
-    mix_.noise = std::clamp(level, 0.0, 1.0);
-  }
+  void setSineMix(Parameter level) { setLevel(mix_.sine, level); }
+  void setTriangleMix(Parameter level) { setLevel(mix_.triangle, level); }
+  void setSawtoothMix(Parameter level) { setLevel(mix_.sawtooth, level); }
+  void setSquareMix(Parameter level) { setLevel(mix_.square, level); }
+  void setNoiseMix(Parameter level) { setLevel(mix_.noise, level); }
 
   /**
    * @brief Set all mix levels at once
    */
-  void setMix(const WaveMix &mix) { mix_ = mix; }
+  void setMix(const WaveMix &mix) {
+    mix_ = mix;
+    updateKernel();
+  }
   void setMix(Parameter sine, Parameter tri, Parameter saw, Parameter sqr,
               Parameter noise = 0.0) {
     mix_.sine = std::clamp(sine, 0.0, 1.0);
@@ -250,6 +315,7 @@ public:
     mix_.sawtooth = std::clamp(saw, 0.0, 1.0);
     mix_.square = std::clamp(sqr, 0.0, 1.0);
     mix_.noise = std::clamp(noise, 0.0, 1.0);
+    updateKernel();
   }
 
   const WaveMix &getMix() const { return mix_; }
@@ -259,97 +325,266 @@ public:
    * @return Mixed output sample
    */
   Sample process() {
-    // Calculate total mix for normalization
-    Parameter totalMix =
-        mix_.sine + mix_.triangle + mix_.sawtooth + mix_.square + mix_.noise;
-    if (totalMix <= 0.0) {
-      advancePhase();
-      return 0.0;
-    }
+    Sample output;
+    (this->*kernel_)(&output, 1);
+    return output;
+  }
 
-    Sample output = 0.0;
+  /**
+   * @brief Render a block of mixed samples
+   * @param out Output buffer (numSamples long)
+   * @param numSamples Number of samples to render
+   */
+  void processBlock(Sample *out, int numSamples) {
+    (this->*kernel_)(out, numSamples);
+  }
 
-    // Generate and mix all active waveforms
-    if (mix_.sine > 0.0) {
-      output += mix_.sine * processSine();
-    }
-    if (mix_.triangle > 0.0) {
-      output += mix_.triangle * processTriangle();
-    }
-    if (mix_.sawtooth > 0.0) {
-      output += mix_.sawtooth * processSaw();
-    }
-    if (mix_.square > 0.0) {
-      output += mix_.square * processSquare();
-    }
-    if (mix_.noise > 0.0) {
-      output += mix_.noise * processNoise();
+  /**
+   * @brief Render a block as a slave of another oscillator
+   *
+   * Read the master's phase before rendering the master's block, and
+   * render the master first when its output is the cross-mod source.
+   *
+   * @param out Output buffer (numSamples long)
+   * @param numSamples Number of samples to render
+   * @param mod Sync and cross-modulation inputs for this block
+   */
+  void processBlock(Sample *out, int numSamples, const OscModulation &mod) {
+    const int modBits = (mod.sync ? SYNC_BIT : 0) |
+                        (mod.cross && mod.crossDepth > 0.0 ? CROSS_BIT : 0);
+    if (!mod.sync)
+      syncPending_ = 0.0;
+    if (modBits == 0) {
+      processBlock(out, numSamples);
+      return;
     }
-
-    // Normalize output
-    output /= totalMix;
-
-    advancePhase();
-    return output;
+    mod_ = mod;
+    (this->*kernels(modBits)[mask_])(out, numSamples);
   }
 
   Phase getPhase() const { return phase_; }
+  Phase getPhaseIncrement() const { return phaseIncrement_; }
 
 private:
+  // Bit per waveform in a kernel mask
+  enum : int {
+    SINE_BIT = 1,
+    TRIANGLE_BIT = 2,
+    SAW_BIT = 4,
+    SQUARE_BIT = 8,
+    NOISE_BIT = 16,
+    NUM_KERNELS = 32
+  };
+
+  // Bit per modulation in a kernel variant
+  enum : int { SYNC_BIT = 1, CROSS_BIT = 2, NUM_MOD_VARIANTS = 4 };
+
+  using Kernel = void (MixingOscillator::*)(Sample *, int);
+  using KernelRow = std::array<Kernel, NUM_KERNELS>;
+
+  /**
+   * @brief Block-invariant inputs of the tonal waves, copied to locals
+   */
+  struct TonalState {
+    WaveMix g;
+    const float *sine;
+    const float *saw;
+    const float *tri;
+    Phase pw;
+    Sample pulseOffset;
+  };
+
   Phase phase_;
   Phase phaseIncrement_;
   Parameter pulseWidth_;
   WaveMix mix_;
+  double sampleRate_ = DEFAULT_SAMPLE_RATE;
+  Frequency frequency_ = 0.0;
 
-  std::mt19937 rng_;
-  std::uniform_real_distribution<double> noiseDist_;
+  // Mix levels divided by their sum (see updateKernel())
+  WaveMix gain_;
+  int mask_ = 0;
+  Kernel kernel_ = nullptr;
 
-  void advancePhase() {
-    phase_ += phaseIncrement_;
-    if (phase_ >= 1.0) {
-      phase_ -= 1.0;
-    }
+  // Slave inputs for the current block, and the BLEP residual owed to
+  // the first sample after a sync that landed on a block boundary
+  OscModulation mod_;
+  Sample syncPending_ = 0.0;
+
+  // Wavetables for the current pitch (see updateTables())
+  const float *sineTable_ = WavetableBank::instance().sine();
+  const float *sawTable_ = nullptr;
+  const float *triTable_ = nullptr;
+
+  NoiseGenerator noise_;
+
+  void setLevel(Parameter &slot, Parameter level) {
+    slot = std::clamp(level, 0.0, 1.0);
+    updateKernel();
   }
 
-  Sample polyBlep(Phase t) const {
-    Phase dt = phaseIncrement_;
-    if (dt <= 0.0)
-      return 0.0;
+  void updateTables() {
+    const WavetableBank &bank = WavetableBank::instance();
+    int level = WavetableBank::levelFor(phaseIncrement_);
+    sawTable_ = bank.saw(level);
+    triTable_ = bank.triangle(level);
+  }
 
-    if (t < dt) {
-      t /= dt;
-      return t + t - t * t - 1.0;
-    } else if (t > 1.0 - dt) {
-      t = (t - 1.0) / dt;
-      return t * t + t + t + 1.0;
+  void updateKernel() {
+    Parameter total =
+        mix_.sine + mix_.triangle + mix_.sawtooth + mix_.square + mix_.noise;
+    int mask = 0;
+    if (total > 0.0) {
+      mask = (mix_.sine > 0.0 ? SINE_BIT : 0) |
+             (mix_.triangle > 0.0 ? TRIANGLE_BIT : 0) |
+             (mix_.sawtooth > 0.0 ? SAW_BIT : 0) |
+             (mix_.square > 0.0 ? SQUARE_BIT : 0) |
+             (mix_.noise > 0.0 ? NOISE_BIT : 0);
+      Parameter norm = 1.0 / total;
+      gain_.sine = mix_.sine * norm;
+      gain_.triangle = mix_.triangle * norm;
+      gain_.sawtooth = mix_.sawtooth * norm;
+      gain_.square = mix_.square * norm;
+      gain_.noise = mix_.noise * norm;
     }
-    return 0.0;
+    mask_ = mask;
+    kernel_ = kernels(0)[mask];
   }
 
-  Sample processSine() const { return std::sin(TWO_PI * phase_); }
+  template <int Mod, int... Masks>
+  static constexpr KernelRow kernelRow(std::integer_sequence<int, Masks...>) {
+    return {{&MixingOscillator::render<Masks, Mod>...}};
+  }
 
-  Sample processSaw() const {
-    Sample saw = 2.0 * phase_ - 1.0;
-    saw -= polyBlep(phase_);
-    return saw;
+  /**
+   * @brief Kernels for one modulation variant, indexed by waveform mask
+   */
+  static const Kernel *kernels(int mod) {
+    using Masks = std::make_integer_sequence<int, NUM_KERNELS>;
+    static const KernelRow table[NUM_MOD_VARIANTS] = {
+        kernelRow<0>(Masks()), kernelRow<SYNC_BIT>(Masks()),
+        kernelRow<CROSS_BIT>(Masks()),
+        kernelRow<SYNC_BIT | CROSS_BIT>(Masks())};
+    return table[mod].data();
   }
 
-  Sample processTriangle() const {
-    if (phase_ < 0.5) {
-      return 4.0 * phase_ - 1.0;
-    } else {
-      return 3.0 - 4.0 * phase_;
+  /**
+   * @brief Sum of the tonal waves at one phase (one shared table position)
+   */
+  template <int Mask>
+  static Sample tonal(const TonalState &t, Phase phase) {
+    double pos = phase * WAVETABLE_SIZE;
+    int index = static_cast<int>(pos);
+    double frac = pos - index;
+    auto lerp = [index, frac](const float *table) {
+      return table[index] + frac * (table[index + 1] - table[index]);
+    };
+
+    Sample output = 0.0;
+    if (Mask & SINE_BIT)
+      output += t.g.sine * lerp(t.sine);
+    if (Mask & TRIANGLE_BIT)
+      output += t.g.triangle * lerp(t.tri);
+    if (Mask & (SAW_BIT | SQUARE_BIT)) {
+      Sample s = lerp(t.saw);
+      if (Mask & SAW_BIT)
+        output += t.g.sawtooth * s;
+      if (Mask & SQUARE_BIT) {
+        // Band-limited pulse as the difference of two phase-shifted saws
+        Phase shifted = phase - t.pw;
+        shifted += shifted < 0.0 ? 1.0 : 0.0;
+        output += t.g.square * (readLinear(t.saw, shifted) - s + t.pulseOffset);
+      }
     }
+    return output;
   }
 
-  Sample processSquare() const {
-    Sample square = (phase_ < pulseWidth_) ? 1.0 : -1.0;
-    square += polyBlep(phase_);
-    square -= polyBlep(std::fmod(phase_ + (1.0 - pulseWidth_), 1.0));
-    return square;
-  }
+  /**
+   * @brief Block kernel for one set of active waveforms
+   *
+   * Noise is filled first as a whole block; the tonal waves share one
+   * table position and are added on top in a single branch-free pass.
+   *
+   * With SYNC_BIT the master phase is stepped alongside, with the
+   * master's own arithmetic. When it wraps d samples before the next
+   * sample, the jump h from the slave's waveform at that instant to its
+   * value at phase 0 gets the two-point PolyBLEP residual: this sample,
+   * 1 - d before the reset, gets +h/2 d^2 and the next one, d after it,
+   * gets -h/2 (1 - d)^2. CROSS_BIT scales the increment per sample by
+   * the master output.
+   */
+  template <int Mask, int Mod> void render(Sample *out, int numSamples) {
+    constexpr bool Sync = (Mod & SYNC_BIT) != 0;
+    constexpr bool Cross = (Mod & CROSS_BIT) != 0;
+
+    if (Mask == 0 && Mod == 0) {
+      // Silent: only keep the phase running for sync
+      std::fill(out, out + numSamples, 0.0);
+      phase_ += phaseIncrement_ * numSamples;
+      phase_ -= std::floor(phase_);
+      return;
+    }
+
+    if (Mask & NOISE_BIT) {
+      noise_.processBlock(out, numSamples);
+      if (Mask == NOISE_BIT && Mod == 0) {
+        for (int i = 0; i < numSamples; ++i)
+          out[i] *= gain_.noise;
+        phase_ += phaseIncrement_ * numSamples;
+        phase_ -= std::floor(phase_);
+        return;
+      }
+    }
 
-  Sample processNoise() { return noiseDist_(rng_); }
+    const TonalState t = {gain_,    sineTable_,  sawTable_,
+                          triTable_, pulseWidth_, 2.0 * pulseWidth_ - 1.0};
+    const Phase inc = phaseIncrement_;
+    Phase phase = phase_;
+
+    // Slave state (unused by the free-running kernels)
+    const Sample *cross = mod_.cross;
+    const Parameter crossDepth = mod_.crossDepth;
+    const Phase masterInc = mod_.masterIncrement;
+    Phase master = mod_.masterPhase;
+    Sample pending = syncPending_;
+
+    for (int i = 0; i < numSamples; ++i) {
+      Sample output = (Mask & NOISE_BIT) ? t.g.noise * out[i] : 0.0;
+      output += tonal<Mask>(t, phase);
+
+      // A band-limited master overshoots -1, so deep FM could run the
+      // phase backwards: hold it instead (through-zero FM is not modelled)
+      const Phase step =
+          Cross ? std::max(inc * (1.0 + crossDepth * cross[i]), 0.0) : inc;
+      bool reset = false;
+      if constexpr (Sync) {
+        output += pending;
+        pending = 0.0;
+        master += masterInc;
+        reset = master >= 1.0;
+        master -= reset ? 1.0 : 0.0;
+      }
+
+      if (reset) {
+        // d = time from the master's wrap to the next sample
+        const Phase d = master / masterInc;
+        Phase before = phase + step * (1.0 - d);
+        before -= before >= 1.0 ? 1.0 : 0.0;
+        const Sample h = tonal<Mask>(t, 0.0) - tonal<Mask>(t, before);
+        output += 0.5 * h * d * d;
+        pending = -0.5 * h * (1.0 - d) * (1.0 - d);
+        phase = d * step;
+      } else {
+        phase += step;
+        phase -= phase >= 1.0 ? 1.0 : 0.0;
+        phase += phase < 0.0 ? 1.0 : 0.0;
+      }
+      out[i] = output;
+    }
+    phase_ = phase;
+    if constexpr (Sync)
+      syncPending_ = pending;
+  }
 };
 
 /**
@@ -357,40 +592,95 @@ private:
  * @brief Digital multi-engine oscillator (like Minilogue XD's third oscillator)
  *
  * Provides additional digital waveforms:
- * - VPM (Variable Phase Modulation / FM)
- * - Wavetable
+ * - VPM: 4-operator FM (see fm_engine.hpp)
+ * - Wavetable: shape scans the frames of a user table, crossfading
+ *   neighbours; without user tables it blends sine into saw
  * - Digital noise with shaping
+ * - Additive: up to 256 sine partials (see additive.hpp)
  */
 class MultiEngine {
 public:
   enum class Mode {
-    VPM,   // FM/Phase modulation
-    WAVES, // Wavetable
-    NOISE  // Shaped noise
+    VPM,     // FM/Phase modulation
+    WAVES,   // Wavetable
+    NOISE,   // Shaped noise
+    ADDITIVE // Sine partials
   };
 
   MultiEngine()
-      : phase_(0.0), phaseIncrement_(0.0), mode_(Mode::VPM), modIndex_(1.0),
-        ratio_(1.0), shape_(0.5) {}
+      : phase_(0.0), phaseIncrement_(0.0), mode_(Mode::VPM), shape_(0.5) {}
+
+  void prepare(double sampleRate) {
+    sampleRate_ = sampleRate;
+    fm_.prepare(sampleRate);
+    additive_.prepare(sampleRate);
+    setFrequency(frequency_);
+  }
 
   void setFrequency(Frequency freq) {
-    phaseIncrement_ = frequencyToPhaseIncrement(freq);
+    frequency_ = freq;
+    phaseIncrement_ = frequencyToPhaseIncrement(freq, sampleRate_);
+    fm_.setFrequency(freq);
+    additive_.setFrequency(freq);
+    updateWaves();
   }
 
   void setMode(Mode m) { mode_ = m; }
+  Mode getMode() const { return mode_; }
+
+  void noteOn() {
+    fm_.noteOn();
+    additive_.noteOn();
+  }
+  void noteOff() { fm_.noteOff(); }
 
   // VPM parameters
-  void setModIndex(Parameter idx) { modIndex_ = idx * 8.0; } // 0-8 range
-  void setRatio(Parameter r) { ratio_ = 1.0 + r * 7.0; }     // 1-8 ratio
+  FmEngine &fm() { return fm_; }
+  void setFmPatch(const FmPatch &patch) { fm_.setPatch(patch); }
+  void setModIndex(Parameter idx) { fm_.setModulationDepth(idx); }
+  void setRatio(Parameter r) { fm_.setOperatorRatio(1, 1.0 + r * 7.0); }
+
+  // ADDITIVE parameters
+  AdditiveEngine &additive() { return additive_; }
+  void setAdditivePatch(const AdditivePatch &patch) {
+    additive_.setPatch(patch);
+  }
 
-  void setShape(Parameter s) { shape_ = s; }
+  void setShape(Parameter s) {
+    shape_ = std::clamp(s, 0.0, 1.0);
+    updateWaves();
+  }
+
+  // WAVES parameters
+
+  /**
+   * @brief User tables for WAVES mode (nullptr = built-in sine/saw blend)
+   *
+   * The set is not copied; it must outlive this engine's use of it.
+   */
+  void setWavetables(const WavetableSet *set) {
+    wavetables_ = set && set->tables > 0 ? set : nullptr;
+    updateWaves();
+  }
+
+  /**
+   * @brief Select a table of the user set (clamped to the set)
+   *
+   * Only moves two pointers, so tables can be switched per note.
+   */
+  void setWaveTable(int index) {
+    waveTable_ = std::max(index, 0);
+    updateWaves();
+  }
+
+  void seedNoise(uint32_t seed) { noise_.seed(seed); }
 
   Sample process() {
     Sample output = 0.0;
 
     switch (mode_) {
     case Mode::VPM:
-      output = processVPM();
+      output = fm_.process();
       break;
     case Mode::WAVES:
       output = processWaves();
@@ -398,6 +688,9 @@ public:
     case Mode::NOISE:
       output = processNoise();
       break;
+    case Mode::ADDITIVE:
+      output = additive_.process();
+      break;
     }
 
     phase_ += phaseIncrement_;
@@ -407,36 +700,98 @@ public:
     return output;
   }
 
+  /**
+   * @brief Render a block of samples
+   * @param out Output buffer (numSamples long)
+   * @param numSamples Number of samples to render
+   */
+  void processBlock(Sample *out, int numSamples) {
+    if (mode_ == Mode::VPM) {
+      fm_.processBlock(out, numSamples);
+      return;
+    }
+    if (mode_ == Mode::ADDITIVE) {
+      additive_.processBlock(out, numSamples);
+      return;
+    }
+    if (mode_ == Mode::WAVES && wavetables_) {
+      renderUserWaves(out, numSamples);
+      return;
+    }
+    for (int i = 0; i < numSamples; ++i)
+      out[i] = process();
+  }
+
 private:
   Phase phase_;
   Phase phaseIncrement_;
   Mode mode_;
-  Parameter modIndex_;
-  Parameter ratio_;
   Parameter shape_;
+  double sampleRate_ = DEFAULT_SAMPLE_RATE;
+  Frequency frequency_ = 0.0;
+
+  NoiseGenerator noise_;
+  FmEngine fm_;
+  AdditiveEngine additive_;
+  const float *sineTable_ = WavetableBank::instance().sine();
+
+  const WavetableSet *wavetables_ = nullptr;
+  int waveTable_ = 0;
+  const float *frameA_ = nullptr; // Frames either side of the shape
+  const float *frameB_ = nullptr;
+  Parameter frameMix_ = 0.0;
+
+  // Resolve table, frame pair and mipmap level to plain pointers
+  void updateWaves() {
+    if (!wavetables_)
+      return;
+    const WavetableSet &set = *wavetables_;
+    const int table = std::min(waveTable_, set.tables - 1);
+    const int level = WavetableBank::levelFor(phaseIncrement_);
+    const double position = shape_ * (set.frames - 1);
+    const int frame = std::min(static_cast<int>(position), set.frames - 1);
+    frameA_ = set.cycle(table, frame, level);
+    frameB_ = set.cycle(table, std::min(frame + 1, set.frames - 1), level);
+    frameMix_ = position - frame;
+  }
 
-  std::mt19937 rng_{std::random_device{}()};
-  std::uniform_real_distribution<double> noiseDist_{-1.0, 1.0};
+  static Sample readFrames(const float *a, const float *b, Parameter mix,
+                           Phase phase) {
+    double pos = phase * WAVETABLE_SIZE;
+    int i = static_cast<int>(pos);
+    double frac = pos - i;
+    Sample x = a[i] + frac * (a[i + 1] - a[i]);
+    Sample y = b[i] + frac * (b[i + 1] - b[i]);
+    return x + mix * (y - x);
+  }
 
-  Sample processVPM() const {
-    // Simple 2-op FM synthesis
-    // Carrier modulated by modulator
-    Phase modPhase = std::fmod(phase_ * ratio_, 1.0);
-    Sample modulator = std::sin(TWO_PI * modPhase);
-    Sample carrier = std::sin(TWO_PI * phase_ + modIndex_ * modulator);
-    return carrier;
+  void renderUserWaves(Sample *out, int numSamples) {
+    const float *a = frameA_;
+    const float *b = frameB_;
+    const Parameter mix = frameMix_;
+    const Phase inc = phaseIncrement_;
+    Phase phase = phase_;
+    for (int i = 0; i < numSamples; ++i) {
+      out[i] = readFrames(a, b, mix, phase);
+      phase += inc;
+      phase -= phase >= 1.0 ? 1.0 : 0.0;
+    }
+    phase_ = phase;
   }
 
   Sample processWaves() const {
+    if (wavetables_)
+      return readFrames(frameA_, frameB_, frameMix_, phase_);
+
     // Simple morphing wavetable (sine -> saw blend)
-    Sample sine = std::sin(TWO_PI * phase_);
+    Sample sine = readLinear(sineTable_, phase_);
     Sample saw = 2.0 * phase_ - 1.0;
     return sine * (1.0 - shape_) + saw * shape_;
   }
 
   Sample processNoise() {
     // Filtered noise based on shape
-    return noiseDist_(rng_);
+    return noise_.next();
   }
 };
 
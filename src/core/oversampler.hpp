@@ -0,0 +1,223 @@
+#pragma once
+/**
+ * @file oversampler.hpp
+ * @brief 2x / 4x polyphase half-band oversampling for nonlinear stages
+ *
+ * Each 2x stage is a polyphase IIR half-band: two parallel chains of
+ * first-order allpass sections in z^-2, one per polyphase branch. Both
+ * branches run at the lower rate, so a stage costs one multiply per
+ * coefficient per low-rate sample, with no FIR delay line. 4x cascades
+ * a steep stage at the base rate with a cheap one at 2x.
+ *
+ * Only the nonlinear parts of the voice (filter drive, ladder tanh) are
+ * wrapped, not the whole engine, so the extra rate is paid only where
+ * aliasing is produced. The allpass sections need one multiplier each,
+ * which maps directly onto FPGA DSP slices.
+ */
+
+#include "types.hpp"
+#include <algorithm>
+
+namespace synth {
+
+constexpr int MAX_OVERSAMPLING = 4;
+
+/**
+ * @brief Base <-> 2x stage: 8 allpass coefficients, transition band 0.04
+ *
+ * Flat to 0.46 fs (< 1e-9 dB ripple), >= 99 dB rejection above 0.54 fs.
+ */
+constexpr int HALF_BAND_STEEP_COEFS = 8;
+inline constexpr double HALF_BAND_STEEP[HALF_BAND_STEEP_COEFS] = {
+    0.04063346092419326, 0.1505051290226746,  0.30075705599187408,
+    0.46077450496145061, 0.6095243148961883,  0.73850384111885725,
+    0.84922381039206607, 0.9497427837050002};
+
+/**
+ * @brief 2x <-> 4x stage: 4 coefficients, transition band 0.25
+ *
+ * The signal only reaches a quarter of this stage's band, so a wide
+ * transition still gives >= 116 dB rejection of the images.
+ */
+constexpr int HALF_BAND_WIDE_COEFS = 4;
+inline constexpr double HALF_BAND_WIDE[HALF_BAND_WIDE_COEFS] = {
+    0.042454709865267573, 0.17073985049749862, 0.39331989319032623,
+    0.74571358872021387};
+
+/**
+ * @class HalfBandStage
+ * @brief One polyphase allpass half-band filter (one direction)
+ *
+ * Even coefficients form branch 0, odd coefficients branch 1. The same
+ * structure serves as interpolator (1 in, 2 out) or decimator (2 in,
+ * 1 out); use separate instances for the two directions.
+ *
+ * @tparam NumCoefs Number of allpass sections (even)
+ */
+template <int NumCoefs> class HalfBandStage {
+public:
+  static_assert(NumCoefs % 2 == 0, "one allpass chain per branch");
+
+  explicit HalfBandStage(const double (&coefs)[NumCoefs]) : coefs_(coefs) {
+    reset();
+  }
+
+  void reset() {
+    std::fill(x_, x_ + NumCoefs, 0.0);
+    std::fill(y_, y_ + NumCoefs, 0.0);
+  }
+
+  /**
+   * @brief Interpolate: one input sample to two output samples
+   */
+  void upsample(Sample in, Sample &out0, Sample &out1) {
+    Sample a = in;
+    Sample b = in;
+    branches(a, b);
+    out0 = a;
+    out1 = b;
+  }
+
+  /**
+   * @brief Decimate: two input samples to one output sample
+   */
+  Sample downsample(Sample in0, Sample in1) {
+    Sample a = in1;
+    Sample b = in0;
+    branches(a, b);
+    return 0.5 * (a + b);
+  }
+
+private:
+  const double *coefs_;
+  Sample x_[NumCoefs]; // Last input of each allpass section
+  Sample y_[NumCoefs]; // Last output of each allpass section
+
+  // y[n] = c * (x[n] - y[n-2]) + x[n-2], in both branches
+  void branches(Sample &a, Sample &b) {
+    for (int k = 0; k < NumCoefs; k += 2) {
+      Sample ta = (a - y_[k]) * coefs_[k] + x_[k];
+      x_[k] = a;
+      y_[k] = ta;
+      a = ta;
+
+      Sample tb = (b - y_[k + 1]) * coefs_[k + 1] + x_[k + 1];
+      x_[k + 1] = b;
+      y_[k + 1] = tb;
+      b = tb;
+    }
+  }
+};
+
+/**
+ * @class Oversampler
+ * @brief Runs a processing callback at 1x, 2x or 4x the base rate
+ *
+ * Blocks go through in chunks of CONTROL_BLOCK_SIZE base-rate samples,
+ * so the high-rate buffer stays small (1 KB) even though every filter
+ * owns one.
+ */
+class Oversampler {
+public:
+  static constexpr int CHUNK = CONTROL_BLOCK_SIZE;
+
+  Oversampler()
+      : upSteep_(HALF_BAND_STEEP), downSteep_(HALF_BAND_STEEP),
+        upWide_(HALF_BAND_WIDE), downWide_(HALF_BAND_WIDE) {}
+
+  /**
+   * @brief Oversampling factor: 1 (off), 2 or 4; 3 rounds down to 2
+   */
+  void setFactor(int factor) {
+    factor = factor >= 4 ? 4 : (factor >= 2 ? 2 : 1);
+    if (factor != factor_) {
+      factor_ = factor;
+      reset();
+    }
+  }
+
+  int getFactor() const { return factor_; }
+
+  /**
+   * @brief Clear the half-band filter state
+   */
+  void reset() {
+    upSteep_.reset();
+    downSteep_.reset();
+    upWide_.reset();
+    downWide_.reset();
+  }
+
+  /**
+   * @brief Process one base-rate sample through fn at the high rate
+   * @param in Input sample
+   * @param fn Sample(Sample) callable, invoked factor times
+   */
+  template <typename Fn> Sample processSample(Sample in, Fn &&fn) {
+    if (factor_ == 1)
+      return fn(in);
+    Sample hi[MAX_OVERSAMPLING];
+    up(&in, hi, 1);
+    for (int i = 0; i < factor_; ++i)
+      hi[i] = fn(hi[i]);
+    Sample out;
+    down(hi, &out, 1);
+    return out;
+  }
+
+  /**
+   * @brief Process a block in place through fn at the high rate
+   * @param buffer Base-rate samples (numSamples long)
+   * @param numSamples Number of base-rate samples
+   * @param fn void(Sample *, int) callable, given high-rate chunks
+   */
+  template <typename Fn>
+  void processBlock(Sample *buffer, int numSamples, Fn &&fn) {
+    if (factor_ == 1) {
+      fn(buffer, numSamples);
+      return;
+    }
+    for (int offset = 0; offset < numSamples; offset += CHUNK) {
+      const int len = std::min(CHUNK, numSamples - offset);
+      up(buffer + offset, high_, len);
+      fn(high_, len * factor_);
+      down(high_, buffer + offset, len);
+    }
+  }
+
+private:
+  int factor_ = 1;
+  HalfBandStage<HALF_BAND_STEEP_COEFS> upSteep_, downSteep_;
+  HalfBandStage<HALF_BAND_WIDE_COEFS> upWide_, downWide_;
+  Sample high_[CHUNK * MAX_OVERSAMPLING];
+
+  // n base-rate samples to n * factor_ high-rate samples
+  void up(const Sample *in, Sample *out, int n) {
+    for (int i = 0; i < n; ++i) {
+      Sample a, b;
+      upSteep_.upsample(in[i], a, b);
+      if (factor_ == 2) {
+        out[2 * i] = a;
+        out[2 * i + 1] = b;
+      } else {
+        upWide_.upsample(a, out[4 * i], out[4 * i + 1]);
+        upWide_.upsample(b, out[4 * i + 2], out[4 * i + 3]);
+      }
+    }
+  }
+
+  // n * factor_ high-rate samples to n base-rate samples
+  void down(const Sample *in, Sample *out, int n) {
+    for (int i = 0; i < n; ++i) {
+      if (factor_ == 2) {
+        out[i] = downSteep_.downsample(in[2 * i], in[2 * i + 1]);
+      } else {
+        Sample a = downWide_.downsample(in[4 * i], in[4 * i + 1]);
+        Sample b = downWide_.downsample(in[4 * i + 2], in[4 * i + 3]);
+        out[i] = downSteep_.downsample(a, b);
+      }
+    }
+  }
+};
+
+} // namespace synth
@@ -0,0 +1,206 @@
+#pragma once
+/**
+ * @file phase_acc_oscillator.hpp
+ * @brief Integer phase-accumulator oscillator (FPGA reference model)
+ *
+ * The phase is a 32-bit PhaseAcc that wraps by unsigned overflow, exactly
+ * like the NCO in the FPGA: no compare-and-subtract, and every phase value
+ * matches the hardware register bit for bit for the same tuning word.
+ *
+ * - Table index = top WAVETABLE_BITS of the accumulator, interpolation
+ *   fraction = the bits below (the hardware ROM address and lerp input)
+ * - PolyBLEP distance to the wrap point = the accumulator itself, or its
+ *   two's complement; the pulse edge is (phase - pulseWidth) mod 2^32
+ * - Noise is a 32-bit Galois LFSR, the same register the FPGA uses
+ *
+ * The per-sample paths are branch-free; the waveform switch is hoisted out
+ * of processBlock().
+ */
+
+#include "types.hpp"
+#include "wavetable.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+
+namespace synth {
+
+/**
+ * @class PhaseAccOscillator
+ * @brief Sine/triangle/saw/square/noise from a wrapping 32-bit accumulator
+ */
+class PhaseAccOscillator {
+public:
+  PhaseAccOscillator() : sineTable_(WavetableBank::instance().sine()) {}
+
+  /**
+   * @brief Set the sample rate (call before processing)
+   * @param sampleRate Sample rate in Hz
+   */
+  void prepare(double sampleRate) {
+    sampleRate_ = sampleRate;
+    setFrequency(frequency_);
+  }
+
+  /**
+   * @brief Set oscillator frequency (rounded to the nearest tuning word)
+   * @param freq Frequency in Hz
+   */
+  void setFrequency(Frequency freq) {
+    frequency_ = freq;
+    setIncrement(frequencyToPhaseAcc(freq, sampleRate_));
+  }
+
+  /**
+   * @brief Set the tuning word directly (as written to the FPGA register)
+   */
+  void setIncrement(PhaseAcc increment) {
+    increment_ = increment;
+    // PolyBLEP works in units of the increment; 0 Hz never reaches an edge
+    invIncrement_ = 1.0 / std::max<double>(increment, 1.0);
+  }
+
+  void setNote(int note) { setFrequency(midiToFrequency(note)); }
+  void setWaveform(Waveform wf) { waveform_ = wf; }
+
+  /**
+   * @brief Set pulse width for square wave
+   * @param pw Pulse width (0.0 to 1.0, 0.5 = square)
+   */
+  void setPulseWidth(Parameter pw) {
+    pulseWidth_ = static_cast<PhaseAcc>(std::clamp(pw, 0.01, 0.99) *
+                                        PHASE_ACC_SCALE);
+  }
+
+  /**
+   * @brief Seed the noise LFSR (0 is remapped; an all-zero LFSR sticks)
+   */
+  void setNoiseSeed(uint32_t seed) { lfsr_ = seed ? seed : 1u; }
+
+  /**
+   * @brief Hard sync - reset phase (called by master oscillator)
+   */
+  void sync() { phase_ = 0; }
+
+  PhaseAcc getPhaseAcc() const { return phase_; }
+  PhaseAcc getIncrement() const { return increment_; }
+  Phase getPhase() const { return phase_ * (1.0 / PHASE_ACC_SCALE); }
+
+  /**
+   * @brief Process one sample
+   * @return Output sample (-1.0 to 1.0)
+   */
+  Sample process() {
+    switch (waveform_) {
+    case Waveform::SINE:
+      return step<Waveform::SINE>();
+    case Waveform::TRIANGLE:
+      return step<Waveform::TRIANGLE>();
+    case Waveform::SAW:
+      return step<Waveform::SAW>();
+    case Waveform::SQUARE:
+      return step<Waveform::SQUARE>();
+    case Waveform::NOISE:
+      return step<Waveform::NOISE>();
+    }
+    return 0.0;
+  }
+
+  /**
+   * @brief Render a block of samples
+   * @param out Output buffer (numSamples long)
+   * @param numSamples Number of samples to render
+   */
+  void processBlock(Sample *out, int numSamples) {
+    switch (waveform_) {
+    case Waveform::SINE:
+      renderBlock<Waveform::SINE>(out, numSamples);
+      break;
+    case Waveform::TRIANGLE:
+      renderBlock<Waveform::TRIANGLE>(out, numSamples);
+      break;
+    case Waveform::SAW:
+      renderBlock<Waveform::SAW>(out, numSamples);
+      break;
+    case Waveform::SQUARE:
+      renderBlock<Waveform::SQUARE>(out, numSamples);
+      break;
+    case Waveform::NOISE:
+      renderBlock<Waveform::NOISE>(out, numSamples);
+      break;
+    }
+  }
+
+private:
+  static constexpr int FRAC_SHIFT = PHASE_ACC_BITS - WAVETABLE_BITS;
+  static constexpr PhaseAcc FRAC_MASK = (PhaseAcc(1) << FRAC_SHIFT) - 1;
+  static constexpr PhaseAcc HALF = PhaseAcc(1) << (PHASE_ACC_BITS - 1);
+  static constexpr uint32_t LFSR_TAPS = 0x80200003u; // x^32+x^22+x^2+x+1
+
+  const float *sineTable_;
+  PhaseAcc phase_ = 0;
+  PhaseAcc increment_ = 0;
+  PhaseAcc pulseWidth_ = HALF;
+  uint32_t lfsr_ = 1u;
+  double invIncrement_ = 1.0;
+  Waveform waveform_ = Waveform::SAW;
+  double sampleRate_ = DEFAULT_SAMPLE_RATE;
+  Frequency frequency_ = 0.0;
+
+  /**
+   * @brief Branch-free PolyBLEP for a wrap at accumulator value 0
+   *
+   * The distance past the edge is p and the distance before it is -p
+   * (mod 2^32), both exact integers. Within one increment of the edge the
+   * correction is -(1 - d)^2 after it and +(1 - d)^2 before it, with d the
+   * distance in increments; elsewhere it is 0.
+   */
+  Sample polyBlep(PhaseAcc p) const {
+    double after = p * invIncrement_;
+    double before = static_cast<PhaseAcc>(0u - p) * invIncrement_;
+    double r = std::max(1.0 - std::min(after, before), 0.0);
+    return (after <= before ? -r : r) * r;
+  }
+
+  // 2p - 1 straight from the accumulator bits
+  static Sample naiveSaw(PhaseAcc p) {
+    return static_cast<int32_t>(p - HALF) * (1.0 / HALF);
+  }
+
+  template <Waveform W> Sample render() {
+    switch (W) {
+    case Waveform::SINE: {
+      PhaseAcc index = phase_ >> FRAC_SHIFT;
+      double frac = (phase_ & FRAC_MASK) * (1.0 / (FRAC_MASK + 1.0));
+      double a = sineTable_[index];
+      return a + frac * (sineTable_[index + 1] - a);
+    }
+    case Waveform::TRIANGLE:
+      return 1.0 - 2.0 * std::fabs(naiveSaw(phase_));
+    case Waveform::SAW:
+      return naiveSaw(phase_) - polyBlep(phase_);
+    case Waveform::SQUARE:
+      return (phase_ < pulseWidth_ ? 1.0 : -1.0) + polyBlep(phase_) -
+             polyBlep(phase_ - pulseWidth_);
+    case Waveform::NOISE: {
+      uint32_t lsb = lfsr_ & 1u;
+      lfsr_ = (lfsr_ >> 1) ^ ((0u - lsb) & LFSR_TAPS);
+      return static_cast<int32_t>(lfsr_) * (1.0 / HALF);
+    }
+    }
+    return 0.0;
+  }
+
+  template <Waveform W> Sample step() {
+    Sample output = render<W>();
+    phase_ += increment_; // Wraps mod 2^32
+    return output;
+  }
+
+  template <Waveform W> void renderBlock(Sample *out, int numSamples) {
+    for (int i = 0; i < numSamples; ++i)
+      out[i] = step<W>();
+  }
+};
+
+} // namespace synth
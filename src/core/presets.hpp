@@ -7,8 +7,11 @@
  * synth patches and drum sounds.
  */
 
+#include "additive.hpp"
+#include "fm_engine.hpp"
 #include "oscillator.hpp"
 #include "types.hpp"
+#include <cmath>
 #include <string>
 
 namespace synth {
@@ -23,7 +26,31 @@ struct SynthPreset {
   // Oscillator wave mix
   WaveMix waveMix;
 
+  // VCO2 pitch offset (semitones) and how VCO1 drives it
+  double osc2Pitch = 0.0;
+  bool oscSync = false;
+  bool ringMod = false;
+  Parameter crossModDepth = 0.0;
+
+  // Unison saw stack (1 voice = off, the two VCOs play)
+  int unisonVoices = 1;
+  Parameter unisonDetune = 0.3;
+  Parameter unisonSpread = 0.5;
+
+  // Multi engine (FM) level in the mixer and its operator settings
+  Parameter multiLevel = 0.0;
+  FmPatch fmPatch;
+
+  // Multi engine mode; WAVES scans user table waveTable by multiShape
+  MultiEngine::Mode multiMode = MultiEngine::Mode::VPM;
+  Parameter multiShape = 0.5;
+  int waveTable = 0;
+
+  // Sine partials for the ADDITIVE mode
+  AdditivePatch additivePatch;
+
   // Filter parameters
+  FilterType filterType = FilterType::SVF;
   Frequency filterCutoff = 2000.0;
   Parameter filterResonance = 0.3;
   Parameter filterDrive = 0.0;
@@ -51,7 +78,7 @@ struct SynthPreset {
  */
 class PresetBank {
 public:
-  static constexpr int NUM_PRESETS = 10;
+  static constexpr int NUM_PRESETS = 14;
 
   static SynthPreset getPreset(int index) {
     switch (index) {
@@ -75,6 +102,14 @@ public:
       return stringsPreset();
     case 9:
       return fmBellPreset();
+    case 10:
+      return syncLeadPreset();
+    case 11:
+      return organPreset();
+    case 12:
+      return glassBellPreset();
+    case 13:
+      return ladderBassPreset();
     default:
       return initPreset();
     }
@@ -83,7 +118,8 @@ public:
   static const char *getPresetName(int index) {
     static const char *names[] = {"Init",    "Bass",   "Lead",   "Pad",
                                   "Kick",    "Snare",  "Hi-Hat", "Pluck",
-                                  "Strings", "FM Bell"};
+                                  "Strings", "FM Bell", "Sync Lead",
+                                  "Organ",   "Glass Bell", "Ladder Bass"};
     if (index >= 0 && index < NUM_PRESETS) {
       return names[index];
     }
@@ -179,7 +215,10 @@ private:
   static SynthPreset stringsPreset() {
     SynthPreset p;
     p.name = "Strings";
-    p.waveMix = {0.0, 0.0, 1.0, 0.0, 0.0}; // Pure Saw (detuned in engine)
+    p.waveMix = {0.0, 0.0, 1.0, 0.0, 0.0}; // Pure Saw
+    p.unisonVoices = 8;                    // Supersaw ensemble
+    p.unisonDetune = 0.35;
+    p.unisonSpread = 0.8;
     p.filterCutoff = 2500.0;
     p.filterResonance = 0.2;
     p.ampAttack = 0.3;
@@ -196,7 +235,14 @@ private:
   static SynthPreset fmBellPreset() {
     SynthPreset p;
     p.name = "FM Bell";
-    p.waveMix = {1.0, 0.0, 0.0, 0.0, 0.0}; // Sine (FM in MultiEngine)
+    p.waveMix = {0.0, 0.0, 0.0, 0.0, 0.0}; // VCOs off: pure FM
+    p.multiLevel = 1.0;
+    // Algorithm 5, two stacks: (OP2 > OP1) + (OP4 > OP3)
+    p.fmPatch.algorithm = 4;
+    p.fmPatch.op[0] = {1.0, 1.0, 0.001, 2.0, 0.0, 1.0};
+    p.fmPatch.op[1] = {3.5, 0.35, 0.001, 1.2, 0.0, 0.8};
+    p.fmPatch.op[2] = {2.0, 0.5, 0.001, 0.8, 0.0, 0.6};
+    p.fmPatch.op[3] = {7.0, 0.2, 0.001, 0.4, 0.0, 0.3};
     p.filterCutoff = 8000.0;
     p.filterResonance = 0.1;
     p.ampAttack = 0.001;
@@ -207,6 +253,98 @@ private:
     return p;
   }
 
+  static SynthPreset syncLeadPreset() {
+    SynthPreset p;
+    p.name = "Sync Lead";
+    p.waveMix = {0.0, 0.0, 1.0, 0.0, 0.0}; // Pure Saw
+    p.osc2Pitch = 19.0;                    // Octave + fifth, synced
+    p.oscSync = true;
+    p.crossModDepth = 0.15;
+    p.filterCutoff = 5000.0;
+    p.filterResonance = 0.25;
+    p.ampAttack = 0.005;
+    p.ampDecay = 0.2;
+    p.ampSustain = 0.8;
+    p.ampRelease = 0.3;
+    p.filterAttack = 0.005;
+    p.filterDecay = 0.3;
+    p.filterSustain = 0.5;
+    p.filterEnvDepth = 0.4;
+    return p;
+  }
+
+  static SynthPreset organPreset() {
+    SynthPreset p;
+    p.name = "Organ";
+    p.waveMix = {0.0, 0.0, 0.0, 0.0, 0.0}; // VCOs off: pure additive
+    p.multiLevel = 1.0;
+    p.multiMode = MultiEngine::Mode::ADDITIVE;
+    // Drawbars 88 8800 008: 16', 5 1/3', 8', 4', 1'
+    for (float ratio : {0.5f, 1.5f, 1.0f, 2.0f, 8.0f})
+      p.additivePatch.add(ratio, 1.0f);
+    // Key click: a burst of upper harmonics gone in 30 ms
+    for (int h = 9; h <= 40; ++h)
+      p.additivePatch.add(static_cast<float>(h), 0.6f / h, 0.03f);
+    p.filterCutoff = 12000.0;
+    p.filterResonance = 0.0;
+    p.ampAttack = 0.003;
+    p.ampDecay = 0.1;
+    p.ampSustain = 1.0;
+    p.ampRelease = 0.05;
+    p.filterEnvDepth = 0.0;
+    return p;
+  }
+
+  static SynthPreset glassBellPreset() {
+    SynthPreset p;
+    p.name = "Glass Bell";
+    p.waveMix = {0.0, 0.0, 0.0, 0.0, 0.0}; // VCOs off: pure additive
+    p.multiLevel = 1.0;
+    p.multiMode = MultiEngine::Mode::ADDITIVE;
+    // Risset's bell: inharmonic partials, higher ones dying sooner
+    const float ratio[] = {0.56f, 0.5617f, 0.92f, 0.9239f, 1.19f, 1.7f,
+                           2.0f,  2.74f,   3.0f,  3.76f,   4.07f};
+    const float level[] = {1.0f,  0.67f, 1.0f,  1.8f,  2.67f, 1.67f,
+                           1.46f, 1.33f, 1.33f, 1.0f,  1.33f};
+    const float decay[] = {6.0f, 5.4f, 3.9f, 3.3f, 1.95f, 2.1f,
+                           1.5f, 1.2f, 0.9f, 0.6f, 0.45f};
+    for (int k = 0; k < 11; ++k)
+      p.additivePatch.add(ratio[k], level[k], decay[k]);
+    // Shimmer: stretched partials up to the top of the range
+    for (int k = 5; k < 200; ++k)
+      p.additivePatch.add(0.56f * std::pow(static_cast<float>(k), 1.08f),
+                          1.0f / k, 4.0f / k);
+    p.filterCutoff = 16000.0;
+    p.filterResonance = 0.0;
+    p.ampAttack = 0.001;
+    p.ampDecay = 6.0;
+    p.ampSustain = 0.0;
+    p.ampRelease = 2.0;
+    p.filterEnvDepth = 0.0;
+    return p;
+  }
+
+  static SynthPreset ladderBassPreset() {
+    SynthPreset p;
+    p.name = "Ladder Bass";
+    p.waveMix = {0.0, 0.0, 1.0, 0.4, 0.0}; // Saw + Square
+    p.osc2Pitch = -12.0;
+    p.filterType = FilterType::LADDER; // 24 dB/oct
+    p.filterCutoff = 300.0;
+    p.filterResonance = 0.45;
+    p.filterDrive = 0.3;
+    p.ampAttack = 0.005;
+    p.ampDecay = 0.4;
+    p.ampSustain = 0.7;
+    p.ampRelease = 0.15;
+    p.filterAttack = 0.001;
+    p.filterDecay = 0.25;
+    p.filterSustain = 0.15;
+    p.filterEnvDepth = 0.7;
+    p.masterVolume = 1.0; // Ladder resonance costs passband level
+    return p;
+  }
+
   // ==================== DRUM PRESETS ====================
 
   static SynthPreset kickPreset() {
@@ -0,0 +1,221 @@
+#pragma once
+/**
+ * @file saturator.hpp
+ * @brief tanh-style saturators in accuracy tiers, chosen at compile time
+ *
+ * Every tier is a stateless struct with the same interface, so a filter
+ * or drive stage takes one as a template parameter and the choice costs
+ * nothing at run time:
+ *
+ *   static Sample process(Sample x);  // scalar
+ *   static Float4 process(Float4 x);  // four lanes
+ *   static constexpr double MAX_ERROR; // max |f(x) - tanh(x)|, all x
+ *
+ * All tiers are odd and monotonic, have unity slope at zero and saturate
+ * at exactly +/-1. None branches: the Float4 forms run four lanes per
+ * step, and saturateBlock() pushes whole buffers through them.
+ *
+ *   Tier            Max error  ns scalar / block  Form
+ *   TanhExact       (ref)      14    / 15         std::tanh
+ *   TanhTable       2.4e-5      3.2  /  2.0       64 points per unit
+ *   TanhPade        9.7e-5      2.7  /  1.4       [7/6] Pade, 1 division
+ *   TanhPolynomial  3.4e-3      2.6  /  1.5       degree 13, no division
+ *   RationalClip    2.4e-2      1.6  /  1.0       [3/2] Pade, SVF drive
+ *
+ * Costs are dsp_benchmark "Saturator" cases less the "none" source case.
+ * Inside a serial loop such as the ladder latency matters more than
+ * throughput: there TanhPade beats the longer polynomial chain.
+ *
+ * On the FPGA the polynomial tier is a DSP-slice Horner chain and the
+ * table tier a block ROM; neither needs a divider.
+ */
+
+#include "simd.hpp"
+#include "types.hpp"
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <type_traits>
+
+namespace synth {
+
+/**
+ * @struct TanhExact
+ * @brief std::tanh, the reference the other tiers are measured against
+ */
+struct TanhExact {
+  static constexpr double MAX_ERROR = 0.0;
+
+  static Sample process(Sample x) { return std::tanh(x); }
+
+  static Float4 process(Float4 x) {
+    alignas(16) float v[SIMD_WIDTH];
+    x.store(v);
+    for (float &s : v)
+      s = std::tanh(s);
+    return Float4::load(v);
+  }
+};
+
+/**
+ * @struct TanhPade
+ * @brief tanh by its [7/6] Pade approximant, clamped where it reaches 1
+ *
+ * The truncated continued fraction of tanh. It crosses 1 at
+ * x = CLAMP, so clamping the input there gives a smooth, exact
+ * saturation; the largest error is 1 - tanh(CLAMP) at that point.
+ */
+struct TanhPade {
+  static constexpr double MAX_ERROR = 9.7e-5;
+  static constexpr double CLAMP = 4.971786858527683;
+
+  static Sample process(Sample x) {
+    x = std::min(std::max(x, -CLAMP), CLAMP);
+    const Sample x2 = x * x;
+    return x * (135135.0 + x2 * (17325.0 + x2 * (378.0 + x2))) /
+           (135135.0 + x2 * (62370.0 + x2 * (3150.0 + 28.0 * x2)));
+  }
+
+  static Float4 process(Float4 x) {
+    const float c = static_cast<float>(CLAMP);
+    x = max(min(x, c), -c);
+    const Float4 x2 = x * x;
+    return x * (135135.0f + x2 * (17325.0f + x2 * (378.0f + x2))) /
+           (135135.0f + x2 * (62370.0f + x2 * (3150.0f + 28.0f * x2)));
+  }
+};
+
+/**
+ * @struct TanhPolynomial
+ * @brief Division-free degree-13 odd polynomial, clamped at +/-3.2
+ *
+ * Minimax fit to tanh on [0, 3.2] with unity slope at zero, and value 1
+ * and slope 0 at the clamp, so the curve is smooth through saturation.
+ * Lower degrees or clamps fit with ripples that break monotonicity.
+ */
+struct TanhPolynomial {
+  static constexpr double MAX_ERROR = 3.4e-3;
+  static constexpr double CLAMP = 3.2;
+
+  static Sample process(Sample x) {
+    x = std::min(std::max(x, -CLAMP), CLAMP);
+    const Sample x2 = x * x;
+    return x * horner(x2);
+  }
+
+  static Float4 process(Float4 x) {
+    const float c = static_cast<float>(CLAMP);
+    x = max(min(x, c), -c);
+    return x * horner(x * x);
+  }
+
+private:
+  static constexpr double C[] = {
+      1.0,
+      -0.3073721228716642,
+      0.08450031432626236,
+      -0.01487597102391429,
+      0.0015172903799412897,
+      -8.100195601518067e-05,
+      1.7431090930667436e-06,
+  };
+
+  template <typename T> static T horner(T x2) {
+    using Coef = typename std::conditional<std::is_same<T, Float4>::value,
+                                           float, Sample>::type;
+    T p = T(static_cast<Coef>(C[6]));
+    for (int k = 5; k >= 0; --k)
+      p = p * x2 + T(static_cast<Coef>(C[k]));
+    return p;
+  }
+};
+
+/**
+ * @struct TanhTable
+ * @brief tanh read from a table over [0, 6], linearly interpolated
+ *
+ * STEPS points per unit; past 6 the output is 1 (tanh(6) = 1 - 1.2e-5).
+ * The table is built during static initialization, never on the audio
+ * thread.
+ */
+struct TanhTable {
+  static constexpr double MAX_ERROR = 2.4e-5;
+  static constexpr int STEPS = 64;
+  static constexpr double RANGE = 6.0;
+  static constexpr int SIZE = static_cast<int>(RANGE) * STEPS + 2;
+
+  static Sample process(Sample x) {
+    const Sample pos = std::min(std::fabs(x), RANGE) * STEPS;
+    const int i = static_cast<int>(pos);
+    const Sample frac = pos - i;
+    const Sample y = table_[i] + frac * (table_[i + 1] - table_[i]);
+    return std::copysign(y, x);
+  }
+
+  static Float4 process(Float4 x) {
+    const Float4 pos =
+        min(abs(x), static_cast<float>(RANGE)) * static_cast<float>(STEPS);
+    const Float4 y = tableLookup(table_.data(), pos);
+    return select(cmplt(x, Float4()), Float4() - y, y);
+  }
+
+private:
+  static std::array<float, SIZE> build() {
+    std::array<float, SIZE> t;
+    for (int i = 0; i < SIZE - 1; ++i)
+      t[i] = static_cast<float>(std::tanh(static_cast<double>(i) / STEPS));
+    t[SIZE - 1] = 1.0f; // Guard for the clamped x = RANGE read
+    t[SIZE - 2] = 1.0f;
+    return t;
+  }
+
+  static inline const std::array<float, SIZE> table_ = build();
+};
+
+/**
+ * @struct RationalClip
+ * @brief x (27 + x^2) / (27 + 9 x^2), clamped at +/-3
+ *
+ * The [3/2] Pade form of tanh, reaching exactly 1 at the clamp. Cheap and
+ * soft, but a loose tanh fit: slope at zero is 1, it bends earlier than
+ * tanh. The SVF and ZDF filter drive curve.
+ */
+struct RationalClip {
+  static constexpr double MAX_ERROR = 2.4e-2;
+
+  static Sample process(Sample x) {
+    x = std::min(std::max(x, -3.0), 3.0);
+    const Sample x2 = x * x;
+    return x * (27.0 + x2) / (27.0 + 9.0 * x2);
+  }
+
+  static Float4 process(Float4 x) {
+    x = max(min(x, 3.0f), -3.0f);
+    const Float4 x2 = x * x;
+    return x * (27.0f + x2) / (27.0f + 9.0f * x2);
+  }
+};
+
+/**
+ * @brief Saturate a block in place: buffer[i] = S(buffer[i] * gain)
+ *
+ * Four samples per step in single precision (Float4), the tail scalar.
+ * For stateless drive stages; filters call process() inside their loops.
+ */
+template <typename Saturator>
+inline void saturateBlock(Sample *buffer, int numSamples, Sample gain) {
+  alignas(16) float lanes[SIMD_WIDTH];
+  const Float4 g = static_cast<float>(gain);
+  int i = 0;
+  for (; i + SIMD_WIDTH <= numSamples; i += SIMD_WIDTH) {
+    for (int k = 0; k < SIMD_WIDTH; ++k)
+      lanes[k] = static_cast<float>(buffer[i + k]);
+    Saturator::process(Float4::load(lanes) * g).store(lanes);
+    for (int k = 0; k < SIMD_WIDTH; ++k)
+      buffer[i + k] = lanes[k];
+  }
+  for (; i < numSamples; ++i)
+    buffer[i] = Saturator::process(buffer[i] * gain);
+}
+
+} // namespace synth
@@ -0,0 +1,263 @@
+#pragma once
+/**
+ * @file simd.hpp
+ * @brief Minimal 4-lane float vector used by the voice-parallel kernels
+ *
+ * Float4 wraps SSE2 when available and falls back to plain arrays
+ * otherwise, so the SoA code compiles everywhere and reads like scalar
+ * math. One lane per voice maps directly onto a parallel FPGA datapath.
+ */
+
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+
+#if defined(__SSE2__) || defined(_M_X64) ||                                    \
+    (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define SYNTH_SIMD_SSE2 1
+#include <emmintrin.h>
+#else
+#define SYNTH_SIMD_SSE2 0
+#endif
+
+namespace synth {
+
+constexpr int SIMD_WIDTH = 4;
+
+/**
+ * @struct Float4
+ * @brief Four packed floats (one per voice lane)
+ *
+ * Comparison results are lane masks (all bits set or clear) meant for
+ * select(), not for arithmetic.
+ */
+struct Float4 {
+#if SYNTH_SIMD_SSE2
+  __m128 v;
+
+  Float4() : v(_mm_setzero_ps()) {}
+  explicit Float4(__m128 x) : v(x) {}
+  Float4(float x) : v(_mm_set1_ps(x)) {}
+
+  static Float4 load(const float *p) { return Float4(_mm_load_ps(p)); }
+  void store(float *p) const { _mm_store_ps(p, v); }
+#else
+  float v[SIMD_WIDTH];
+
+  Float4() : v{0.0f, 0.0f, 0.0f, 0.0f} {}
+  Float4(float x) : v{x, x, x, x} {}
+
+  static Float4 load(const float *p) {
+    Float4 r;
+    std::memcpy(r.v, p, sizeof(r.v));
+    return r;
+  }
+  void store(float *p) const { std::memcpy(p, v, sizeof(v)); }
+#endif
+};
+
+#if SYNTH_SIMD_SSE2
+
+inline Float4 operator+(Float4 a, Float4 b) {
+  return Float4(_mm_add_ps(a.v, b.v));
+}
+inline Float4 operator-(Float4 a, Float4 b) {
+  return Float4(_mm_sub_ps(a.v, b.v));
+}
+inline Float4 operator*(Float4 a, Float4 b) {
+  return Float4(_mm_mul_ps(a.v, b.v));
+}
+inline Float4 operator/(Float4 a, Float4 b) {
+  return Float4(_mm_div_ps(a.v, b.v));
+}
+inline Float4 min(Float4 a, Float4 b) { return Float4(_mm_min_ps(a.v, b.v)); }
+inline Float4 max(Float4 a, Float4 b) { return Float4(_mm_max_ps(a.v, b.v)); }
+inline Float4 abs(Float4 a) {
+  return Float4(_mm_andnot_ps(_mm_set1_ps(-0.0f), a.v));
+}
+
+inline Float4 cmplt(Float4 a, Float4 b) {
+  return Float4(_mm_cmplt_ps(a.v, b.v));
+}
+inline Float4 cmpgt(Float4 a, Float4 b) {
+  return Float4(_mm_cmpgt_ps(a.v, b.v));
+}
+inline Float4 cmpge(Float4 a, Float4 b) {
+  return Float4(_mm_cmpge_ps(a.v, b.v));
+}
+
+/** @brief Per lane: mask ? a : b */
+inline Float4 select(Float4 mask, Float4 a, Float4 b) {
+  return Float4(
+      _mm_or_ps(_mm_and_ps(mask.v, a.v), _mm_andnot_ps(mask.v, b.v)));
+}
+
+/** @brief Per lane: mask ? a : 0 */
+inline Float4 maskAnd(Float4 mask, Float4 a) {
+  return Float4(_mm_and_ps(mask.v, a.v));
+}
+
+/** @brief Bit i set when lane i of the mask is set */
+inline int moveMask(Float4 mask) { return _mm_movemask_ps(mask.v); }
+
+/** @brief Per lane floor (|x| < 2^31) */
+inline Float4 floor(Float4 x) {
+  __m128 t = _mm_cvtepi32_ps(_mm_cvttps_epi32(x.v));
+  return Float4(
+      _mm_sub_ps(t, _mm_and_ps(_mm_cmpgt_ps(t, x.v), _mm_set1_ps(1.0f))));
+}
+
+/**
+ * @brief Per lane linear-interpolated table read at position pos
+ *
+ * SSE2 has no gather, so only the two table loads are scalar.
+ *
+ * @param table Table with at least one guard sample past the last index
+ * @param pos Read positions (0 <= pos < table length)
+ */
+inline Float4 tableLookup(const float *table, Float4 pos) {
+  __m128i index = _mm_cvttps_epi32(pos.v);
+  __m128 frac = _mm_sub_ps(pos.v, _mm_cvtepi32_ps(index));
+  alignas(16) int32_t i[SIMD_WIDTH];
+  _mm_store_si128(reinterpret_cast<__m128i *>(i), index);
+  __m128 a = _mm_setr_ps(table[i[0]], table[i[1]], table[i[2]], table[i[3]]);
+  __m128 b = _mm_setr_ps(table[i[0] + 1], table[i[1] + 1], table[i[2] + 1],
+                         table[i[3] + 1]);
+  return Float4(_mm_add_ps(a, _mm_mul_ps(frac, _mm_sub_ps(b, a))));
+}
+
+/** @brief Sum of the four lanes, as (a0 + a1) + (a2 + a3) */
+inline float horizontalSum(Float4 a) {
+  __m128 pairs = _mm_add_ps(a.v, _mm_shuffle_ps(a.v, a.v, 0xB1));
+  return _mm_cvtss_f32(_mm_add_ss(pairs, _mm_movehl_ps(pairs, pairs)));
+}
+
+#else
+
+namespace detail {
+inline uint32_t bits(float x) {
+  uint32_t u;
+  std::memcpy(&u, &x, sizeof(u));
+  return u;
+}
+inline float fromBits(uint32_t u) {
+  float x;
+  std::memcpy(&x, &u, sizeof(x));
+  return x;
+}
+inline float maskOf(bool b) { return fromBits(b ? 0xFFFFFFFFu : 0u); }
+} // namespace detail
+
+#define SYNTH_FLOAT4_LANEWISE(expr)                                            \
+  Float4 r;                                                                    \
+  for (int i = 0; i < SIMD_WIDTH; ++i)                                         \
+    r.v[i] = (expr);                                                           \
+  return r;
+
+inline Float4 operator+(Float4 a, Float4 b) {
+  SYNTH_FLOAT4_LANEWISE(a.v[i] + b.v[i])
+}
+inline Float4 operator-(Float4 a, Float4 b) {
+  SYNTH_FLOAT4_LANEWISE(a.v[i] - b.v[i])
+}
+inline Float4 operator*(Float4 a, Float4 b) {
+  SYNTH_FLOAT4_LANEWISE(a.v[i] * b.v[i])
+}
+inline Float4 operator/(Float4 a, Float4 b) {
+  SYNTH_FLOAT4_LANEWISE(a.v[i] / b.v[i])
+}
+inline Float4 min(Float4 a, Float4 b) {
+  SYNTH_FLOAT4_LANEWISE(a.v[i] < b.v[i] ? a.v[i] : b.v[i])
+}
+inline Float4 max(Float4 a, Float4 b) {
+  SYNTH_FLOAT4_LANEWISE(a.v[i] > b.v[i] ? a.v[i] : b.v[i])
+}
+inline Float4 abs(Float4 a) { SYNTH_FLOAT4_LANEWISE(std::fabs(a.v[i])) }
+
+inline Float4 cmplt(Float4 a, Float4 b) {
+  SYNTH_FLOAT4_LANEWISE(detail::maskOf(a.v[i] < b.v[i]))
+}
+inline Float4 cmpgt(Float4 a, Float4 b) {
+  SYNTH_FLOAT4_LANEWISE(detail::maskOf(a.v[i] > b.v[i]))
+}
+inline Float4 cmpge(Float4 a, Float4 b) {
+  SYNTH_FLOAT4_LANEWISE(detail::maskOf(a.v[i] >= b.v[i]))
+}
+
+inline Float4 select(Float4 mask, Float4 a, Float4 b) {
+  SYNTH_FLOAT4_LANEWISE(detail::bits(mask.v[i]) ? a.v[i] : b.v[i])
+}
+
+inline Float4 maskAnd(Float4 mask, Float4 a) {
+  SYNTH_FLOAT4_LANEWISE(detail::bits(mask.v[i]) ? a.v[i] : 0.0f)
+}
+
+inline int moveMask(Float4 mask) {
+  int m = 0;
+  for (int i = 0; i < SIMD_WIDTH; ++i)
+    m |= (detail::bits(mask.v[i]) >> 31) << i;
+  return m;
+}
+
+inline Float4 floor(Float4 x) { SYNTH_FLOAT4_LANEWISE(std::floor(x.v[i])) }
+
+inline Float4 tableLookup(const float *table, Float4 pos) {
+  Float4 r;
+  for (int i = 0; i < SIMD_WIDTH; ++i) {
+    int index = static_cast<int>(pos.v[i]);
+    float frac = pos.v[i] - static_cast<float>(index);
+    r.v[i] = table[index] + frac * (table[index + 1] - table[index]);
+  }
+  return r;
+}
+
+inline float horizontalSum(Float4 a) {
+  return (a.v[0] + a.v[1]) + (a.v[2] + a.v[3]);
+}
+
+#undef SYNTH_FLOAT4_LANEWISE
+
+#endif
+
+inline Float4 &operator+=(Float4 &a, Float4 b) { return a = a + b; }
+inline Float4 &operator-=(Float4 &a, Float4 b) { return a = a - b; }
+inline Float4 &operator*=(Float4 &a, Float4 b) { return a = a * b; }
+
+// =============================================================================
+// Vector Math Helpers
+// =============================================================================
+
+/**
+ * @brief Wrap phase back into [0, 1) after a single increment
+ */
+inline Float4 wrapPhase(Float4 phase) {
+  return phase - maskAnd(cmpge(phase, 1.0f), 1.0f);
+}
+
+/**
+ * @brief sin(2*pi*phase) for phase in [0, 1)
+ *
+ * Parabolic approximation with one refinement step; max error ~0.001,
+ * well below the oscillator mix noise floor.
+ */
+inline Float4 sin2Pi(Float4 phase) {
+  // Map to x in [-1, 1) so that sin(2*pi*phase) = -sin(pi*x)
+  Float4 x = phase * 2.0f - 1.0f;
+  Float4 y = x * 4.0f * (1.0f - abs(x));
+  y = 0.225f * (y * abs(y) - y) + y;
+  return 0.0f - y;
+}
+
+/**
+ * @brief PolyBLEP residual for a rising phase at t with increment dt
+ * @param invDt Precomputed 1 / dt
+ */
+inline Float4 polyBlep(Float4 t, Float4 dt, Float4 invDt) {
+  Float4 a = t * invDt;
+  Float4 low = a + a - a * a - 1.0f;
+  Float4 b = (t - 1.0f) * invDt;
+  Float4 high = b * b + b + b + 1.0f;
+  return maskAnd(cmplt(t, dt), low) + maskAnd(cmpgt(t, 1.0f - dt), high);
+}
+
+} // namespace synth
@@ -28,12 +28,20 @@ namespace synth {
 // Configuration Constants
 // =============================================================================
 
-constexpr double SAMPLE_RATE = 192000.0; // 192 kHz
-constexpr double NYQUIST = SAMPLE_RATE / 2.0;
-constexpr double SAMPLE_PERIOD = 1.0 / SAMPLE_RATE;
+// Rate used until prepare() is called with the real device rate
+constexpr double DEFAULT_SAMPLE_RATE = 192000.0; // 192 kHz
 
-constexpr int NUM_VOICES = 4;
-constexpr int OVERSAMPLING = 1; // Can increase for anti-aliasing
+constexpr int NUM_VOICES = 4;     // Default polyphony (FPGA target)
+constexpr int MAX_POLYPHONY = 64; // Largest voice pool the engine allocates
+// Default filter oversampling (1, 2 or 4): only the nonlinear filter
+// stages run at the higher rate, see oversampler.hpp
+constexpr int OVERSAMPLING = 1;
+
+// Largest block rendered in one pass; longer periods are split into chunks
+constexpr int MAX_BLOCK_SIZE = 256;
+
+// Modulation (envelopes, LFO, cutoff) is evaluated once per control block
+constexpr int CONTROL_BLOCK_SIZE = 32;
 
 // =============================================================================
 // Type Aliases (Easy to swap for fixed-point later)
@@ -73,10 +81,30 @@ inline Frequency midiToFrequency(int note) {
 /**
  * @brief Convert frequency to phase increment
  * @param freq Frequency in Hz
+ * @param sampleRate Sample rate in Hz
  * @return Phase increment per sample (0.0 to 1.0 range)
  */
-inline Phase frequencyToPhaseIncrement(Frequency freq) {
-  return freq / SAMPLE_RATE;
+inline Phase frequencyToPhaseIncrement(Frequency freq, double sampleRate) {
+  return freq / sampleRate;
+}
+
+constexpr int PHASE_ACC_BITS = 32;
+constexpr double PHASE_ACC_SCALE = 4294967296.0; // 2^32
+
+/**
+ * @brief Convert frequency to a 32-bit phase accumulator tuning word
+ *
+ * Rounds to nearest. Loading the same word into the FPGA accumulator
+ * reproduces the integer oscillators' phase sequence bit for bit.
+ *
+ * @param freq Frequency in Hz (0 to sampleRate / 2)
+ * @param sampleRate Sample rate in Hz
+ * @return Increment added to the accumulator each sample (wraps mod 2^32)
+ */
+inline PhaseAcc frequencyToPhaseAcc(Frequency freq, double sampleRate) {
+  double word = std::floor(freq / sampleRate * PHASE_ACC_SCALE + 0.5);
+  return static_cast<PhaseAcc>(
+      static_cast<uint64_t>(std::max(word, 0.0)) & 0xFFFFFFFFull);
 }
 
 // =============================================================================
@@ -106,4 +134,12 @@ enum class Waveform { SINE, TRIANGLE, SAW, SQUARE, NOISE };
 
 enum class FilterMode { LOWPASS, HIGHPASS, BANDPASS, NOTCH };
 
+/**
+ * @brief Filter model a voice runs (see Voice::setFilterType)
+ *
+ * SVF: 12 dB/oct Chamberlin, all FilterMode outputs. LADDER: 24 dB/oct
+ * Moog-style low-pass. ZDF: 12 dB/oct TPT state variable.
+ */
+enum class FilterType { SVF, LADDER, ZDF };
+
 } // namespace synth
@@ -0,0 +1,238 @@
+#pragma once
+/**
+ * @file unison.hpp
+ * @brief Detuned, stereo-spread saw stack (unison / supersaw)
+ *
+ * Up to UNISON_MAX_VOICES saws per synth voice. Their phases, increments
+ * and pan gains sit in contiguous aligned arrays and are processed four at
+ * a time as Float4 lanes with the vector PolyBLEP, so a stack costs about
+ * one oscillator per SIMD step instead of one object per saw. Unused lanes
+ * in the last group have zero gain and zero increment.
+ *
+ * On the FPGA this is one time-multiplexed saw core stepping through a
+ * phase RAM, with the pan gains in a small coefficient ROM.
+ */
+
+#include "noise.hpp"
+#include "simd.hpp"
+#include "types.hpp"
+#include <algorithm>
+#include <cmath>
+
+namespace synth {
+
+constexpr int UNISON_MAX_VOICES = 16;
+
+/** @brief Detune of the outermost saws at detune = 1, in cents */
+constexpr double UNISON_MAX_DETUNE_CENTS = 50.0;
+
+/**
+ * @class UnisonOscillator
+ * @brief N detuned PolyBLEP saws mixed to a stereo pair
+ */
+class UnisonOscillator {
+public:
+  UnisonOscillator() { updateGains(); }
+
+  /**
+   * @brief Set the sample rate (call before processing)
+   * @param sampleRate Sample rate in Hz
+   */
+  void prepare(double sampleRate) {
+    sampleRate_ = sampleRate;
+    updateIncrements();
+  }
+
+  /**
+   * @brief Set the centre frequency of the stack
+   * @param freq Frequency in Hz
+   */
+  void setFrequency(Frequency freq) {
+    frequency_ = freq;
+    updateIncrements();
+  }
+
+  /**
+   * @brief Number of saws in the stack (1..UNISON_MAX_VOICES)
+   */
+  void setVoices(int count) {
+    count = std::clamp(count, 1, UNISON_MAX_VOICES);
+    if (count == voices_)
+      return;
+    voices_ = count;
+    groups_ = (count + SIMD_WIDTH - 1) / SIMD_WIDTH;
+    updateIncrements();
+    updateGains();
+  }
+
+  /**
+   * @brief Detune amount (0 = unison, 1 = outer saws +-50 cents)
+   */
+  void setDetune(Parameter amount) {
+    detune_ = std::clamp(amount, 0.0, 1.0);
+    updateIncrements();
+  }
+
+  /**
+   * @brief Stereo spread (0 = mono, 1 = outer saws hard left/right)
+   */
+  void setSpread(Parameter amount) {
+    spread_ = std::clamp(amount, 0.0, 1.0);
+    updateGains();
+  }
+
+  int getVoices() const { return voices_; }
+  Parameter getDetune() const { return detune_; }
+  Parameter getSpread() const { return spread_; }
+
+  /**
+   * @brief true when left and right differ (spread > 0, more than one saw)
+   */
+  bool isStereo() const { return voices_ > 1 && spread_ > 0.0; }
+
+  void seedNoise(uint32_t seed) { noise_.seed(seed); }
+
+  /**
+   * @brief Start every saw at a random phase
+   *
+   * Free-running phases keep the stack from starting as one loud,
+   * phase-aligned saw that then sweeps into a comb.
+   */
+  void noteOn() {
+    for (int k = 0; k < voices_; ++k)
+      phase_[k] = static_cast<float>(noise_.next() * 0.5 + 0.5);
+  }
+
+  /**
+   * @brief Process one stereo sample
+   */
+  void process(Sample &left, Sample &right) {
+    processBlock(&left, &right, 1);
+  }
+
+  /**
+   * @brief Render a block of stereo samples
+   * @param left Left output (numSamples long)
+   * @param right Right output (numSamples long)
+   * @param numSamples Number of samples to render
+   */
+  void processBlock(Sample *left, Sample *right, int numSamples) {
+    switch (groups_) {
+    case 1:
+      render<1>(left, right, numSamples);
+      break;
+    case 2:
+      render<2>(left, right, numSamples);
+      break;
+    case 3:
+      render<3>(left, right, numSamples);
+      break;
+    case 4:
+      render<4>(left, right, numSamples);
+      break;
+    }
+  }
+
+private:
+  static_assert(UNISON_MAX_VOICES % SIMD_WIDTH == 0,
+                "unison arrays are processed in whole SIMD groups");
+
+  alignas(16) float phase_[UNISON_MAX_VOICES] = {};
+  alignas(16) float increment_[UNISON_MAX_VOICES] = {};
+  alignas(16) float invIncrement_[UNISON_MAX_VOICES] = {};
+  alignas(16) float gainLeft_[UNISON_MAX_VOICES] = {};
+  alignas(16) float gainRight_[UNISON_MAX_VOICES] = {};
+
+  int voices_ = 1;
+  int groups_ = 1;
+  Parameter detune_ = 0.3;
+  Parameter spread_ = 0.5;
+  Frequency frequency_ = 440.0;
+  double sampleRate_ = DEFAULT_SAMPLE_RATE;
+  NoiseGenerator noise_;
+
+  /**
+   * @brief Position of saw k across the stack, -1 .. 1
+   */
+  double position(int k) const {
+    return voices_ > 1 ? 2.0 * k / (voices_ - 1) - 1.0 : 0.0;
+  }
+
+  void updateIncrements() {
+    const double cents = detune_ * UNISON_MAX_DETUNE_CENTS;
+    for (int k = 0; k < UNISON_MAX_VOICES; ++k) {
+      if (k >= voices_) {
+        increment_[k] = 0.0f;
+        invIncrement_[k] = 0.0f; // PolyBLEP of a stopped lane is 0
+        continue;
+      }
+      double ratio = std::pow(2.0, position(k) * cents / 1200.0);
+      double inc = std::min(frequency_ * ratio / sampleRate_, 0.5);
+      increment_[k] = static_cast<float>(inc);
+      invIncrement_[k] = static_cast<float>(1.0 / std::max(inc, 1e-9));
+    }
+  }
+
+  /**
+   * @brief Equal-power pan gains, normalized to the RMS of one saw
+   *
+   * Neighbouring saws in pitch go to opposite sides so both channels
+   * carry the whole detune spread.
+   */
+  void updateGains() {
+    const double norm = std::sqrt(2.0 / voices_);
+    for (int k = 0; k < UNISON_MAX_VOICES; ++k) {
+      if (k >= voices_) {
+        gainLeft_[k] = gainRight_[k] = 0.0f;
+        continue;
+      }
+      double side = (k & 1) ? 1.0 : -1.0;
+      double pan = spread_ * std::fabs(position(k)) * side;
+      double angle = (pan + 1.0) * (PI / 4.0);
+      gainLeft_[k] = static_cast<float>(std::cos(angle) * norm);
+      gainRight_[k] = static_cast<float>(std::sin(angle) * norm);
+    }
+  }
+
+  // 2p - 1 with the PolyBLEP residual at the wrap
+  static Float4 sawSample(Float4 phase, Float4 inc, Float4 invInc) {
+    return phase * 2.0f - 1.0f - polyBlep(phase, inc, invInc);
+  }
+
+  /**
+   * @brief Stack kernel for a fixed number of SIMD groups
+   *
+   * State lives in locals for the whole block so the group loop unrolls
+   * and the output stores cannot alias it.
+   */
+  template <int Groups>
+  void render(Sample *left, Sample *right, int numSamples) {
+    Float4 phase[Groups], inc[Groups], invInc[Groups];
+    Float4 gainL[Groups], gainR[Groups];
+    for (int g = 0; g < Groups; ++g) {
+      const int k = g * SIMD_WIDTH;
+      phase[g] = Float4::load(phase_ + k);
+      inc[g] = Float4::load(increment_ + k);
+      invInc[g] = Float4::load(invIncrement_ + k);
+      gainL[g] = Float4::load(gainLeft_ + k);
+      gainR[g] = Float4::load(gainRight_ + k);
+    }
+
+    for (int i = 0; i < numSamples; ++i) {
+      Float4 sumL, sumR;
+      for (int g = 0; g < Groups; ++g) {
+        Float4 saw = sawSample(phase[g], inc[g], invInc[g]);
+        sumL += saw * gainL[g];
+        sumR += saw * gainR[g];
+        phase[g] = wrapPhase(phase[g] + inc[g]);
+      }
+      left[i] = horizontalSum(sumL);
+      right[i] = horizontalSum(sumR);
+    }
+
+    for (int g = 0; g < Groups; ++g)
+      phase[g].store(phase_ + g * SIMD_WIDTH);
+  }
+};
+
+} // namespace synth
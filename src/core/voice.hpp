@@ -4,9 +4,13 @@
  * @brief Complete synthesizer voice
  *
  * Combines all components into a single synth voice:
- * - 2 MixingOscillators with waveform blending
+ * - 2 MixingOscillators with waveform blending; VCO2 can be hard-synced,
+ *   ring-modulated or frequency-modulated by VCO1
+ * - Unison saw stack (replaces the oscillators when enabled)
+ * - MultiEngine (4-operator FM by default)
  * - Mixer
- * - Filter with drive
+ * - Filter with drive, SVF, ladder or ZDF model (a second one for the
+ *   right channel when the unison stack is spread in stereo)
  * - 2 ADSR envelopes (amp + filter)
  */
 
@@ -14,12 +18,51 @@
 #include "filter.hpp"
 #include "oscillator.hpp"
 #include "types.hpp"
+#include "unison.hpp"
+#include <array>
+#include <variant>
 
 namespace synth {
 
 // Forward declaration
 struct SynthPreset;
 
+/**
+ * @struct VoiceScratch
+ * @brief Intermediate buffers shared by all voices during block rendering
+ *
+ * Owned by the engine so each voice does not carry its own copy. In
+ * unison mode osc1/osc2 hold the left/right output of the saw stack.
+ */
+struct VoiceScratch {
+  std::array<Sample, MAX_BLOCK_SIZE> osc1;
+  std::array<Sample, MAX_BLOCK_SIZE> osc2;
+  std::array<Sample, MAX_BLOCK_SIZE> multi;
+};
+
+/**
+ * @struct FilterPair
+ * @brief A voice's left and right filter of one model
+ */
+template <typename Filter> struct FilterPair {
+  /** @brief Both filters from the same constructor arguments */
+  template <typename... Args>
+  explicit FilterPair(const Args &...args) : left(args...), right(args...) {}
+
+  Filter left;
+  Filter right; // Stereo unison only
+};
+
+/**
+ * @brief Per-voice filter state, one model at a time
+ *
+ * Alternatives are in FilterType order. Only the active model is
+ * constructed, in one block of storage inside the voice.
+ */
+using VoiceFilters =
+    std::variant<FilterPair<StateVariableFilter>, FilterPair<LadderFilter>,
+                 FilterPair<ZdfFilter>>;
+
 /**
  * @class Voice
  * @brief Single polyphonic voice with wave mixing and full ADSR control
@@ -32,6 +75,22 @@ public:
     osc2_.setMix(0.0, 0.0, 1.0, 0.0, 0.0);
   }
 
+  /**
+   * @brief Set the sample rate for every module (call before processing)
+   * @param sampleRate Sample rate in Hz
+   */
+  void prepare(double sampleRate) {
+    osc1_.prepare(sampleRate);
+    osc2_.prepare(sampleRate);
+    unison_.prepare(sampleRate);
+    multi_.prepare(sampleRate);
+    sampleRate_ = sampleRate;
+    filterTables_ = FilterTables::forRate(sampleRate, oversampling_);
+    forEachFilter([sampleRate](auto &f) { f.prepare(sampleRate); });
+    ampEnv_.prepare(sampleRate);
+    filterEnv_.prepare(sampleRate);
+  }
+
   /**
    * @brief Trigger note on
    * @param note MIDI note number
@@ -43,17 +102,21 @@ public:
     active_ = true;
     Frequency baseFreq = midiToFrequency(note);
     osc1_.setFrequency(baseFreq);
-    osc2_.setFrequency(baseFreq * 1.002); // Slight detune for richness
+    updateOsc2Frequency();
+    unison_.setFrequency(baseFreq);
+    unison_.noteOn();
     multi_.setFrequency(baseFreq);
+    multi_.noteOn();
     ampEnv_.noteOn();
     filterEnv_.noteOn();
-    filter_.reset();
+    forEachFilter([](auto &f) { f.reset(); });
   }
 
   /**
    * @brief Trigger note off
    */
   void noteOff() {
+    multi_.noteOff();
     ampEnv_.noteOff();
     filterEnv_.noteOff();
   }
@@ -70,6 +133,26 @@ public:
    */
   int getNote() const { return note_; }
 
+  /**
+   * @brief Current output level (amp envelope times velocity)
+   */
+  Sample getLevel() const { return ampEnv_.getOutput() * velocity_; }
+
+  /**
+   * @brief Whether the amp envelope is still rising towards its peak
+   */
+  bool isAttacking() const { return ampEnv_.getStage() == ADSR::Stage::ATTACK; }
+
+  /**
+   * @brief Restart every noise source in the voice from one seed
+   */
+  void seedNoise(uint32_t seed) {
+    osc1_.seedNoise(seed);
+    osc2_.seedNoise(seed + 1);
+    multi_.seedNoise(seed + 2);
+    unison_.seedNoise(mixSeed(seed));
+  }
+
   /**
    * @brief Force stop voice
    */
@@ -176,11 +259,87 @@ public:
     osc2_.setMix(mix);
   }
 
+  // ==================== VCO2 Modulation ====================
+
+  /**
+   * @brief VCO2 pitch offset in semitones (sync sweeps live here)
+   */
+  void setOsc2Pitch(double semitones) {
+    osc2Semitones_ = semitones;
+    updateOsc2Frequency();
+  }
+
+  /** @brief Hard sync VCO2 to VCO1 (band-limited, see MixingOscillator) */
+  void setOscSync(bool on) { sync_ = on; }
+
+  /** @brief Replace VCO2 with VCO1 x VCO2 */
+  void setRingMod(bool on) { ring_ = on; }
+
+  /** @brief VCO1 -> VCO2 linear FM depth (0..1) */
+  void setCrossModDepth(Parameter depth) {
+    crossMod_ = std::clamp(depth, 0.0, 1.0);
+  }
+
   // ==================== Filter Setters ====================
 
-  void setFilterCutoff(Frequency freq) { baseCutoff_ = freq; }
-  void setFilterResonance(Parameter res) { filter_.setResonance(res); }
-  void setFilterDrive(Parameter drive) { filter_.setDrive(drive); }
+  void setFilterCutoff(Frequency freq) {
+    baseCutoff_ = freq;
+    basePitch_ = cutoffToPitch(std::max(freq, MIN_CUTOFF));
+  }
+  void setFilterResonance(Parameter res) {
+    filterResonance_ = res;
+    forEachFilter([res](auto &f) { f.setResonance(res); });
+  }
+
+  void setFilterDrive(Parameter drive) {
+    filterDrive_ = drive;
+    forEachFilter([drive](auto &f) { f.setDrive(drive); });
+  }
+
+  /**
+   * @brief Filter oversampling factor (1, 2 or 4), used while driven
+   */
+  void setOversampling(int factor) {
+    oversampling_ = factor;
+    filterTables_ = FilterTables::forRate(sampleRate_, factor);
+    forEachFilter([factor](auto &f) { f.setOversampling(factor); });
+  }
+
+  /**
+   * @brief Switch the filter model
+   *
+   * Builds the new model in place of the old one at the voice's rate and
+   * oversampling, then re-applies resonance and drive; its state starts
+   * from silence. It takes the coefficient tables prepare() fetched, so
+   * this is safe on the audio thread. A no-op if the model is unchanged.
+   */
+  void setFilterType(FilterType type) {
+    if (type == getFilterType())
+      return;
+    switch (type) {
+    case FilterType::LADDER:
+      filters_.emplace<FilterPair<LadderFilter>>(sampleRate_, oversampling_,
+                                                 filterTables_);
+      break;
+    case FilterType::ZDF:
+      filters_.emplace<FilterPair<ZdfFilter>>(sampleRate_, oversampling_,
+                                              filterTables_);
+      break;
+    case FilterType::SVF:
+    default:
+      filters_.emplace<FilterPair<StateVariableFilter>>(
+          sampleRate_, oversampling_, filterTables_);
+      break;
+    }
+    forEachFilter([this](auto &f) {
+      f.setResonance(filterResonance_);
+      f.setDrive(filterDrive_);
+    });
+  }
+
+  FilterType getFilterType() const {
+    return static_cast<FilterType>(filters_.index());
+  }
 
   // ==================== Envelope Setters ====================
 
@@ -212,6 +371,34 @@ public:
   void setFilterEnvDepth(Parameter depth) { filterEnvDepth_ = depth; }
   void setOscMix(Parameter mix) { oscMix_ = mix; }
 
+  // ==================== Unison ====================
+
+  /**
+   * @brief Saws in the unison stack (1 = off, the two VCOs play)
+   */
+  void setUnisonVoices(int count) { unison_.setVoices(count); }
+  void setUnisonDetune(Parameter amount) { unison_.setDetune(amount); }
+  void setUnisonSpread(Parameter amount) { unison_.setSpread(amount); }
+  bool isUnison() const { return unison_.getVoices() > 1; }
+
+  // ==================== Multi Engine ====================
+
+  /**
+   * @brief Multi engine level in the mixer (0 = not rendered at all)
+   */
+  void setMultiLevel(Parameter level) {
+    multiLevel_ = std::clamp(level, 0.0, 1.0);
+  }
+  void setMultiMode(MultiEngine::Mode mode) { multi_.setMode(mode); }
+  void setMultiShape(Parameter shape) { multi_.setShape(shape); }
+  void setWavetables(const WavetableSet *set) { multi_.setWavetables(set); }
+  void setWaveTable(int index) { multi_.setWaveTable(index); }
+  void setFmPatch(const FmPatch &patch) { multi_.setFmPatch(patch); }
+  void setAdditivePatch(const AdditivePatch &patch) {
+    multi_.setAdditivePatch(patch);
+  }
+  MultiEngine &multi() { return multi_; }
+
   // ==================== Getters ====================
 
   const WaveMix &getWaveMix() const { return osc1_.getMix(); }
@@ -220,7 +407,7 @@ public:
 
   /**
    * @brief Process one sample
-   * @param lfoValue External LFO value for modulation
+   * @param lfoValue LFO cutoff modulation in octaves
    * @return Audio sample
    */
   Sample process(Sample lfoValue = 0.0) {
@@ -232,19 +419,88 @@ public:
     Sample ampEnvVal = ampEnv_.process();
     Sample filterEnvVal = filterEnv_.process();
 
-    // Mix both oscillators
-    Sample osc1Out = osc1_.process();
-    Sample osc2Out = osc2_.process();
-    Sample mix = osc1Out * (1.0 - oscMix_) + osc2Out * oscMix_;
+    // Mix both oscillators, or fold the unison stack to mono
+    Sample mix;
+    if (isUnison()) {
+      Sample left, right;
+      unison_.process(left, right);
+      mix = (left + right) * 0.5;
+    } else {
+      Sample osc1Out, osc2Out;
+      const OscModulation mod = osc2Modulation(&osc1Out);
+      osc1Out = osc1_.process();
+      osc2_.processBlock(&osc2Out, 1, mod);
+      if (ring_)
+        osc2Out *= osc1Out;
+      mix = osc1Out * (1.0 - oscMix_) + osc2Out * oscMix_;
+    }
+    if (multiLevel_ > 0.0)
+      mix += multi_.process() * multiLevel_;
+
+    // Filter envelope and LFO modulation, in octaves
+    const double pitch =
+        cutoffPitch(filterEnvVal * filterEnvDepth_ * 4.0, lfoValue);
+
+    Sample filtered = std::visit(
+        [pitch, mix](auto &pair) {
+          pair.left.setCutoffPitch(pitch);
+          return pair.left.process(mix);
+        },
+        filters_);
+    return filtered * ampEnvVal * velocity_;
+  }
 
-    // Apply filter envelope modulation
-    Frequency cutoff =
-        baseCutoff_ * std::pow(2.0, filterEnvVal * filterEnvDepth_ * 4.0);
-    cutoff += lfoValue * 1000.0;
-    filter_.setCutoff(std::clamp(cutoff, 20.0, 20000.0));
+  /**
+   * @brief Render a block and add it to the output buffers
+   *
+   * Oscillators render the whole block into scratch. Envelopes, LFO and
+   * cutoff are then evaluated once per CONTROL_BLOCK_SIZE sub-block; the
+   * filter coefficient and VCA gain are interpolated linearly across it.
+   * Only a stereo unison stack runs the second filter; otherwise both
+   * channels get the same signal. The filter model is dispatched once
+   * per block, into a loop compiled for that model.
+   *
+   * @param left Left accumulation buffer (numSamples long, not cleared)
+   * @param right Right accumulation buffer (numSamples long, not cleared)
+   * @param lfo LFO cutoff modulation in octaves, one per control sub-block
+   * @param numSamples Number of samples (at most MAX_BLOCK_SIZE)
+   * @param scratch Engine-owned scratch buffers
+   */
+  void processBlock(Sample *left, Sample *right, const Sample *lfo,
+                    int numSamples, VoiceScratch &scratch) {
+    if (!isActive()) {
+      active_ = false;
+      return;
+    }
 
-    Sample filtered = filter_.process(mix);
-    return filtered * ampEnvVal * velocity_;
+    Sample *osc1 = scratch.osc1.data();
+    Sample *osc2 = scratch.osc2.data();
+    const bool unison = isUnison();
+    const bool stereo = unison && unison_.isStereo();
+    if (unison) {
+      unison_.processBlock(osc1, osc2, numSamples);
+    } else {
+      // VCO1 is the master: read its phase before it advances
+      const OscModulation mod = osc2Modulation(osc1);
+      osc1_.processBlock(osc1, numSamples);
+      osc2_.processBlock(osc2, numSamples, mod);
+      if (ring_) {
+        for (int i = 0; i < numSamples; ++i)
+          osc2[i] *= osc1[i];
+      }
+    }
+    if (multiLevel_ > 0.0)
+      multi_.processBlock(scratch.multi.data(), numSamples);
+
+    std::visit(
+        [&](auto &pair) {
+          renderBlock(pair, left, right, lfo, numSamples, scratch, unison,
+                      stereo);
+        },
+        filters_);
+
+    if (!ampEnv_.isActive())
+      active_ = false;
   }
 
 private:
@@ -252,12 +508,130 @@ private:
   int note_;
   double velocity_;
   MixingOscillator osc1_, osc2_; // Now using MixingOscillator!
+  UnisonOscillator unison_;
   MultiEngine multi_;
-  StateVariableFilter filter_;
+  VoiceFilters filters_;
   ADSR ampEnv_, filterEnv_;
   Frequency baseCutoff_ = 2000.0;
+  double basePitch_ = cutoffToPitch(2000.0);
   Parameter filterEnvDepth_ = 0.5;
   Parameter oscMix_ = 0.5;
+  Parameter multiLevel_ = 0.0;
+  double osc2Semitones_ = 0.0;
+  bool sync_ = false;
+  bool ring_ = false;
+  Parameter crossMod_ = 0.0;
+
+  // Filter settings, kept to set up a newly selected model
+  double sampleRate_ = DEFAULT_SAMPLE_RATE;
+  Parameter filterResonance_ = 0.0;
+  Parameter filterDrive_ = 0.0;
+  int oversampling_ = OVERSAMPLING;
+  FilterTables filterTables_ =
+      FilterTables::forRate(DEFAULT_SAMPLE_RATE, OVERSAMPLING);
+
+  /**
+   * @brief Apply f to both filters of the active model
+   */
+  template <typename Fn> void forEachFilter(Fn &&f) {
+    std::visit(
+        [&f](auto &pair) {
+          f(pair.left);
+          f(pair.right);
+        },
+        filters_);
+  }
+
+  /**
+   * @brief processBlock() from the mixer on, for one filter model
+   *
+   * scratch.osc1/osc2 hold the rendered oscillators (the unison stack's
+   * left/right when unison is on).
+   */
+  template <typename Filter>
+  void renderBlock(FilterPair<Filter> &filters, Sample *left, Sample *right,
+                   const Sample *lfo, int numSamples, VoiceScratch &scratch,
+                   bool unison, bool stereo) {
+    Sample *osc1 = scratch.osc1.data();
+    Sample *osc2 = scratch.osc2.data();
+    const bool withMulti = multiLevel_ > 0.0;
+    const Sample envScale = filterEnvDepth_ * 4.0;
+    for (int offset = 0, k = 0; offset < numSamples;
+         offset += CONTROL_BLOCK_SIZE, ++k) {
+      const int len = std::min(CONTROL_BLOCK_SIZE, numSamples - offset);
+      Sample *buf = osc1 + offset;
+      Sample *buf2 = osc2 + offset;
+
+      // Control rate: one envelope/LFO/cutoff evaluation per sub-block
+      Sample ampStart = ampEnv_.getOutput() * velocity_;
+      Sample ampEnd = ampEnv_.advance(len) * velocity_;
+      Sample filterEnvVal = filterEnv_.advance(len);
+
+      const double pitch = cutoffPitch(filterEnvVal * envScale, lfo[k]);
+      filters.left.rampCutoffPitch(pitch, len);
+
+      // Audio rate: mix, filter, VCA
+      if (!unison) {
+        for (int i = 0; i < len; ++i)
+          buf[i] = buf[i] * (1.0 - oscMix_) + buf2[i] * oscMix_;
+      }
+      if (withMulti) {
+        const Sample *multi = scratch.multi.data() + offset;
+        for (int i = 0; i < len; ++i)
+          buf[i] += multi[i] * multiLevel_;
+        if (stereo) {
+          for (int i = 0; i < len; ++i)
+            buf2[i] += multi[i] * multiLevel_;
+        }
+      }
+
+      filters.left.processBlock(buf, len);
+      const Sample *bufRight = buf;
+      if (stereo) {
+        filters.right.rampCutoffPitch(pitch, len);
+        filters.right.processBlock(buf2, len);
+        bufRight = buf2;
+      }
+
+      Sample gain = ampStart;
+      const Sample gainStep = (ampEnd - ampStart) / len;
+      for (int i = 0; i < len; ++i) {
+        gain += gainStep;
+        left[offset + i] += buf[i] * gain;
+        right[offset + i] += bufRight[i] * gain;
+      }
+    }
+  }
+
+  /**
+   * @brief Modulated cutoff pitch: the envelope and LFO add octaves
+   */
+  double cutoffPitch(double envOctaves, Sample lfo) const {
+    return std::clamp(basePitch_ + envOctaves + lfo, MIN_CUTOFF_PITCH,
+                      MAX_CUTOFF_PITCH);
+  }
+
+  void updateOsc2Frequency() {
+    // Slight detune for richness
+    osc2_.setFrequency(midiToFrequency(note_) * 1.002 *
+                       std::pow(2.0, osc2Semitones_ / 12.0));
+  }
+
+  /**
+   * @brief VCO2's slave inputs for the next block (VCO1 not yet rendered)
+   * @param master VCO1's output buffer for cross modulation
+   */
+  OscModulation osc2Modulation(const Sample *master) const {
+    OscModulation mod;
+    mod.sync = sync_;
+    mod.masterPhase = osc1_.getPhase();
+    mod.masterIncrement = osc1_.getPhaseIncrement();
+    if (crossMod_ > 0.0) {
+      mod.cross = master;
+      mod.crossDepth = crossMod_;
+    }
+    return mod;
+  }
 };
 
 } // namespace synth
@@ -0,0 +1,317 @@
+#pragma once
+/**
+ * @file wavetable.hpp
+ * @brief Mipmapped band-limited wavetables and a table-lookup oscillator
+ *
+ * One shared bank holds a sine table plus per-octave saw and triangle
+ * tables. Level k of a mipmap keeps only the harmonics that stay below
+ * Nyquist for every pitch in its octave, so reading the level chosen from
+ * the phase increment is alias-free without any per-sample correction.
+ * Pulse/square waves are built from two saw reads (saw(p - pw) - saw(p)),
+ * which keeps pulse-width modulation band-limited too.
+ *
+ * On the FPGA the same tables map to block ROMs indexed by the top bits of
+ * the phase accumulator.
+ */
+
+#include "types.hpp"
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+namespace synth {
+
+constexpr int WAVETABLE_BITS = 11;
+constexpr int WAVETABLE_SIZE = 1 << WAVETABLE_BITS; // 2048 samples/cycle
+constexpr int WAVETABLE_LEVELS = WAVETABLE_BITS;    // 1024 .. 1 harmonics
+
+/** @brief Floats per stored cycle: one guard sample before, two after */
+constexpr int WAVETABLE_STRIDE = WAVETABLE_SIZE + 3;
+
+/**
+ * @brief Store one cycle with its guard samples
+ * @param dst WAVETABLE_STRIDE floats
+ * @param cycle WAVETABLE_SIZE samples
+ */
+inline void storeCycle(float *dst, const double *cycle) {
+  dst[0] = static_cast<float>(cycle[WAVETABLE_SIZE - 1]);
+  for (int n = 0; n < WAVETABLE_SIZE; ++n)
+    dst[n + 1] = static_cast<float>(cycle[n]);
+  dst[WAVETABLE_SIZE + 1] = static_cast<float>(cycle[0]);
+  dst[WAVETABLE_SIZE + 2] = static_cast<float>(cycle[1]);
+}
+
+/**
+ * @class WavetableBank
+ * @brief Process-wide read-only tables, built once on first use
+ *
+ * Each table is stored with one guard sample before and two after the
+ * cycle, so linear and 4-point cubic reads never wrap their index.
+ */
+class WavetableBank {
+public:
+  /**
+   * @brief The shared bank (thread-safe lazy construction)
+   *
+   * First use allocates and builds the tables; oscillators touch it in
+   * their constructors so this never happens on the audio thread.
+   */
+  static const WavetableBank &instance() {
+    static const WavetableBank bank;
+    return bank;
+  }
+
+  const float *sine() const { return table(sine_, 0); }
+  const float *saw(int level) const { return table(saw_, level); }
+  const float *triangle(int level) const { return table(triangle_, level); }
+
+  /**
+   * @brief Mipmap level for a phase increment
+   *
+   * Level k holds (WAVETABLE_SIZE / 2) >> k harmonics, which stay below
+   * Nyquist for increments up to 2^k / WAVETABLE_SIZE.
+   */
+  static int levelFor(Phase increment) {
+    int exponent;
+    double mantissa = std::frexp(increment * WAVETABLE_SIZE, &exponent);
+    int level = mantissa > 0.5 ? exponent : exponent - 1;
+    return std::clamp(level, 0, WAVETABLE_LEVELS - 1);
+  }
+
+private:
+  static constexpr int STRIDE = WAVETABLE_STRIDE;
+
+  std::vector<float> sine_;
+  std::vector<float> saw_;
+  std::vector<float> triangle_;
+
+  WavetableBank() {
+    // Exact sine by index: sin(2*pi*h*n/N) = ref[(h*n) mod N]
+    std::vector<double> ref(WAVETABLE_SIZE);
+    for (int n = 0; n < WAVETABLE_SIZE; ++n)
+      ref[n] = std::sin(TWO_PI * n / WAVETABLE_SIZE);
+
+    std::vector<double> cycle(WAVETABLE_SIZE);
+    sine_.resize(STRIDE);
+    store(sine_, 0, ref);
+
+    saw_.resize(static_cast<size_t>(STRIDE) * WAVETABLE_LEVELS);
+    triangle_.resize(static_cast<size_t>(STRIDE) * WAVETABLE_LEVELS);
+    for (int level = 0; level < WAVETABLE_LEVELS; ++level) {
+      const int harmonics = (WAVETABLE_SIZE / 2) >> level;
+
+      // Saw 2p - 1 = -(2/pi) * sum(sin(2*pi*h*p) / h)
+      std::fill(cycle.begin(), cycle.end(), 0.0);
+      for (int h = 1; h <= harmonics; ++h)
+        addHarmonic(cycle, ref, h, -2.0 / (PI * h), 0);
+      store(saw_, level, cycle);
+
+      // Triangle (-1 at p = 0, +1 at p = 0.5): odd cosine harmonics
+      std::fill(cycle.begin(), cycle.end(), 0.0);
+      for (int h = 1; h <= harmonics; h += 2)
+        addHarmonic(cycle, ref, h, -8.0 / (PI * PI * h * h),
+                    WAVETABLE_SIZE / 4);
+      store(triangle_, level, cycle);
+    }
+  }
+
+  // Accumulate gain * sin(2*pi*(h*n + offset)/N); offset N/4 gives cosine
+  static void addHarmonic(std::vector<double> &cycle,
+                          const std::vector<double> &ref, int h, double gain,
+                          int offset) {
+    const unsigned mask = WAVETABLE_SIZE - 1;
+    for (int n = 0; n < WAVETABLE_SIZE; ++n)
+      cycle[n] += gain * ref[(static_cast<unsigned>(h) *
+                                  static_cast<unsigned>(n) +
+                              static_cast<unsigned>(offset)) &
+                             mask];
+  }
+
+  static void store(std::vector<float> &dst, int level,
+                    const std::vector<double> &cycle) {
+    storeCycle(dst.data() + static_cast<size_t>(level) * STRIDE, cycle.data());
+  }
+
+  static const float *table(const std::vector<float> &data, int level) {
+    return data.data() + static_cast<size_t>(level) * STRIDE + 1;
+  }
+};
+
+/**
+ * @struct WavetableSet
+ * @brief Non-owning view of user wavetables in the bank's layout
+ *
+ * tables x frames single cycles, each stored as WAVETABLE_LEVELS mipmap
+ * levels of WAVETABLE_STRIDE floats, so the same level choice and reads
+ * apply. The data normally lives in a read-only mapped file (see
+ * io/wavetable_file.hpp) shared by every voice and engine.
+ */
+struct WavetableSet {
+  const float *data = nullptr;
+  int tables = 0;
+  int frames = 0;
+
+  /**
+   * @brief One mipmap level of one frame (index 0 is the first sample)
+   */
+  const float *cycle(int table, int frame, int level) const {
+    size_t index =
+        (static_cast<size_t>(table) * frames + frame) * WAVETABLE_LEVELS +
+        level;
+    return data + index * WAVETABLE_STRIDE + 1;
+  }
+};
+
+// =============================================================================
+// Table Reads
+// =============================================================================
+
+/**
+ * @brief Linear-interpolated read
+ * @param table Table from WavetableBank
+ * @param phase Phase in [0, 1)
+ */
+inline Sample readLinear(const float *table, Phase phase) {
+  double pos = phase * WAVETABLE_SIZE;
+  int i = static_cast<int>(pos);
+  double frac = pos - i;
+  return table[i] + frac * (table[i + 1] - table[i]);
+}
+
+/**
+ * @brief 4-point cubic Hermite read (smoother for sparse tables)
+ * @param table Table from WavetableBank
+ * @param phase Phase in [0, 1)
+ */
+inline Sample readCubic(const float *table, Phase phase) {
+  double pos = phase * WAVETABLE_SIZE;
+  int i = static_cast<int>(pos);
+  double x = pos - i;
+  double y0 = table[i - 1], y1 = table[i], y2 = table[i + 1],
+         y3 = table[i + 2];
+  double c1 = 0.5 * (y2 - y0);
+  double c2 = y0 - 2.5 * y1 + 2.0 * y2 - 0.5 * y3;
+  double c3 = 0.5 * (y3 - y0) + 1.5 * (y1 - y2);
+  return ((c3 * x + c2) * x + c1) * x + y1;
+}
+
+/**
+ * @brief sin(2*pi*phase) for any phase, from the shared sine table
+ *
+ * Max error ~1e-6 (linear interpolation over 2048 points).
+ */
+inline Sample tableSin(Phase phase) {
+  return readLinear(WavetableBank::instance().sine(),
+                    phase - std::floor(phase));
+}
+
+// =============================================================================
+// Wavetable Oscillator
+// =============================================================================
+
+/**
+ * @class WavetableOscillator
+ * @brief Band-limited sine/triangle/saw/pulse oscillator from the bank
+ */
+class WavetableOscillator {
+public:
+  enum class Interpolation { LINEAR, CUBIC };
+
+  WavetableOscillator() : bank_(&WavetableBank::instance()) {
+    updateTables();
+  }
+
+  void prepare(double sampleRate) {
+    sampleRate_ = sampleRate;
+    setFrequency(frequency_);
+  }
+
+  /**
+   * @brief Set frequency; also picks the mipmap level for this pitch
+   */
+  void setFrequency(Frequency freq) {
+    frequency_ = freq;
+    phaseIncrement_ = frequencyToPhaseIncrement(freq, sampleRate_);
+    updateTables();
+  }
+
+  /**
+   * @brief Set waveform (NOISE is not table-based and renders silence)
+   */
+  void setWaveform(Waveform wf) { waveform_ = wf; }
+  void setPulseWidth(Parameter pw) { pulseWidth_ = std::clamp(pw, 0.01, 0.99); }
+  void setInterpolation(Interpolation interp) { interpolation_ = interp; }
+
+  void sync() { phase_ = 0.0; }
+  Phase getPhase() const { return phase_; }
+
+  Sample process() {
+    Sample output = interpolation_ == Interpolation::CUBIC ? render<true>()
+                                                           : render<false>();
+    phase_ += phaseIncrement_;
+    if (phase_ >= 1.0)
+      phase_ -= 1.0;
+    return output;
+  }
+
+  void processBlock(Sample *out, int numSamples) {
+    if (interpolation_ == Interpolation::CUBIC)
+      renderBlock<true>(out, numSamples);
+    else
+      renderBlock<false>(out, numSamples);
+  }
+
+private:
+  const WavetableBank *bank_;
+  const float *sawTable_ = nullptr;
+  const float *triTable_ = nullptr;
+  Phase phase_ = 0.0;
+  Phase phaseIncrement_ = 0.0;
+  Parameter pulseWidth_ = 0.5;
+  Waveform waveform_ = Waveform::SAW;
+  Interpolation interpolation_ = Interpolation::LINEAR;
+  double sampleRate_ = DEFAULT_SAMPLE_RATE;
+  Frequency frequency_ = 0.0;
+
+  void updateTables() {
+    int level = WavetableBank::levelFor(phaseIncrement_);
+    sawTable_ = bank_->saw(level);
+    triTable_ = bank_->triangle(level);
+  }
+
+  template <bool Cubic> static Sample read(const float *table, Phase phase) {
+    return Cubic ? readCubic(table, phase) : readLinear(table, phase);
+  }
+
+  template <bool Cubic> Sample render() const {
+    switch (waveform_) {
+    case Waveform::SINE:
+      return read<Cubic>(bank_->sine(), phase_);
+    case Waveform::TRIANGLE:
+      return read<Cubic>(triTable_, phase_);
+    case Waveform::SAW:
+      return read<Cubic>(sawTable_, phase_);
+    case Waveform::SQUARE: {
+      Phase shifted = phase_ - pulseWidth_;
+      if (shifted < 0.0)
+        shifted += 1.0;
+      return read<Cubic>(sawTable_, shifted) - read<Cubic>(sawTable_, phase_) +
+             2.0 * pulseWidth_ - 1.0;
+    }
+    case Waveform::NOISE:
+      break;
+    }
+    return 0.0;
+  }
+
+  template <bool Cubic> void renderBlock(Sample *out, int numSamples) {
+    for (int i = 0; i < numSamples; ++i) {
+      out[i] = render<Cubic>();
+      phase_ += phaseIncrement_;
+      if (phase_ >= 1.0)
+        phase_ -= 1.0;
+    }
+  }
+};
+
+} // namespace synth
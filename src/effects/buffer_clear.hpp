@@ -0,0 +1,47 @@
+#pragma once
+/**
+ * @file buffer_clear.hpp
+ * @brief Zeroing effect delay memory a slice at a time
+ */
+
+#include "../core/types.hpp"
+#include <algorithm>
+#include <cstddef>
+#include <initializer_list>
+#include <vector>
+
+namespace synth {
+
+/**
+ * @brief Zero a set of buffers a slice at a time
+ *
+ * The buffers count as one concatenated range; each call zeroes up to
+ * maxSamples more of it, so a large clear can be spread over audio
+ * blocks.
+ *
+ * @param buffers The buffers, in a fixed order across calls
+ * @param pos Samples already cleared, 0 to start; advanced by the call
+ * @param maxSamples Most samples to zero in this call
+ * @return true once every buffer is zero
+ */
+inline bool
+clearBuffersPartial(std::initializer_list<std::vector<Sample> *> buffers,
+                    size_t &pos, size_t maxSamples) {
+  size_t start = 0; // Offset of the current buffer in the whole range
+  for (std::vector<Sample> *buffer : buffers) {
+    const size_t size = buffer->size();
+    if (pos < start + size) {
+      const size_t from = pos - start;
+      const size_t count = std::min(size - from, maxSamples);
+      std::fill(buffer->begin() + from, buffer->begin() + from + count, 0.0);
+      pos += count;
+      maxSamples -= count;
+      if (maxSamples == 0)
+        return pos == start + size && buffer == *(buffers.end() - 1);
+    }
+    start += size;
+  }
+  return true;
+}
+
+} // namespace synth
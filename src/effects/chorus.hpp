@@ -6,6 +6,7 @@
 
 #include "../core/lfo.hpp"
 #include "../core/types.hpp"
+#include "buffer_clear.hpp"
 #include <algorithm>
 #include <cmath>
 #include <vector>
@@ -20,14 +21,28 @@ namespace synth {
 class Chorus {
 public:
   Chorus() : writePos_(0), rate_(0.5), depth_(0.5), mix_(0.5), baseDelay_(7.0) {
-    size_t bufSize = static_cast<size_t>(50.0 * SAMPLE_RATE / 1000.0);
-    bufferL_.resize(bufSize, 0.0);
-    bufferR_.resize(bufSize, 0.0);
-
     lfoL_.setRate(rate_);
     lfoR_.setRate(rate_);
     lfoL_.setShape(LFO::Shape::SINE);
     lfoR_.setShape(LFO::Shape::SINE);
+    prepare(DEFAULT_SAMPLE_RATE);
+  }
+
+  /**
+   * @brief Set the sample rate and reallocate the delay lines
+   *
+   * Allocates; call before audio starts, never from the audio thread.
+   *
+   * @param sampleRate Sample rate in Hz
+   */
+  void prepare(double sampleRate) {
+    samplesPerMs_ = sampleRate / 1000.0;
+    size_t bufSize = static_cast<size_t>(50.0 * samplesPerMs_);
+    bufferL_.assign(bufSize, 0.0);
+    bufferR_.assign(bufSize, 0.0);
+    writePos_ = 0;
+    lfoL_.prepare(sampleRate);
+    lfoR_.prepare(sampleRate);
   }
 
   /**
@@ -76,6 +91,70 @@ public:
     writePos_ = (writePos_ + 1) % bufferL_.size();
   }
 
+  /**
+   * @brief Process a block of stereo samples in place
+   *
+   * Same output as calling process() per sample; the LFOs are rendered
+   * per chunk and the ring index wraps without a modulo.
+   */
+  void processBlock(Sample *left, Sample *right, int numSamples) {
+    Sample modL[MAX_BLOCK_SIZE];
+    Sample modR[MAX_BLOCK_SIZE];
+    const size_t size = bufferL_.size();
+    const double depthSamples = depth_ * 3.0 * samplesPerMs_;
+    const double baseSamples = baseDelay_ * samplesPerMs_;
+    const Parameter dry = 1.0 - mix_;
+
+    while (numSamples > 0) {
+      int n = std::min(numSamples, MAX_BLOCK_SIZE);
+      lfoL_.processBlock(modL, n);
+      lfoR_.processBlock(modR, n);
+
+      for (int i = 0; i < n; ++i) {
+        bufferL_[writePos_] = left[i];
+        bufferR_[writePos_] = right[i];
+
+        Sample chorusL =
+            readAt(bufferL_, baseSamples + modL[i] * depthSamples);
+        Sample chorusR =
+            readAt(bufferR_, baseSamples + modR[i] * depthSamples);
+
+        left[i] = left[i] * dry + chorusL * mix_;
+        right[i] = right[i] * dry + chorusR * mix_;
+
+        if (++writePos_ == size)
+          writePos_ = 0;
+      }
+
+      left += n;
+      right += n;
+      numSamples -= n;
+    }
+  }
+
+  /**
+   * @brief Samples until the output is silent after the input stops
+   */
+  size_t getTailSamples() const {
+    return static_cast<size_t>((baseDelay_ + 3.0) * samplesPerMs_) + 2;
+  }
+
+  /**
+   * @brief Clear delay buffers
+   */
+  void clear() {
+    std::fill(bufferL_.begin(), bufferL_.end(), 0.0);
+    std::fill(bufferR_.begin(), bufferR_.end(), 0.0);
+  }
+
+  /**
+   * @brief clear() in slices (see clearBuffersPartial)
+   * @return true once the buffers are clear
+   */
+  bool clearPartial(size_t &pos, size_t maxSamples) {
+    return clearBuffersPartial({&bufferL_, &bufferR_}, pos, maxSamples);
+  }
+
 private:
   std::vector<Sample> bufferL_, bufferR_;
   size_t writePos_;
@@ -84,9 +163,10 @@ private:
   Parameter depth_;
   Parameter mix_;
   double baseDelay_;
+  double samplesPerMs_;
 
   Sample readInterpolated(const std::vector<Sample> &buffer, double delayMs) {
-    double delaySamples = delayMs * SAMPLE_RATE / 1000.0;
+    double delaySamples = delayMs * samplesPerMs_;
     double readPosF = static_cast<double>(writePos_) - delaySamples;
     if (readPosF < 0)
       readPosF += buffer.size();
@@ -97,6 +177,21 @@ private:
 
     return buffer[idx0] * (1.0 - frac) + buffer[idx1] * frac;
   }
+
+  // Block-path read: delay is always shorter than the buffer
+  Sample readAt(const std::vector<Sample> &buffer, double delaySamples) const {
+    double readPosF = static_cast<double>(writePos_) - delaySamples;
+    if (readPosF < 0)
+      readPosF += buffer.size();
+
+    size_t idx0 = static_cast<size_t>(readPosF);
+    double frac = readPosF - static_cast<double>(idx0);
+    size_t idx1 = idx0 + 1;
+    if (idx1 == buffer.size())
+      idx1 = 0;
+
+    return buffer[idx0] * (1.0 - frac) + buffer[idx1] * frac;
+  }
 };
 
 } // namespace synth
@@ -5,7 +5,9 @@
  */
 
 #include "../core/types.hpp"
+#include "buffer_clear.hpp"
 #include <algorithm>
+#include <cmath>
 #include <vector>
 
 namespace synth {
@@ -21,10 +23,24 @@ public:
    * @param maxDelayMs Maximum delay time in milliseconds
    */
   Delay(double maxDelayMs = 2000.0)
-      : writePos_(0), delayTime_(500.0), feedback_(0.5), mix_(0.5) {
-    size_t maxSamples = static_cast<size_t>(maxDelayMs * SAMPLE_RATE / 1000.0);
-    bufferL_.resize(maxSamples, 0.0);
-    bufferR_.resize(maxSamples, 0.0);
+      : writePos_(0), delayTime_(500.0), maxDelayMs_(maxDelayMs),
+        feedback_(0.5), mix_(0.5) {
+    prepare(DEFAULT_SAMPLE_RATE);
+  }
+
+  /**
+   * @brief Set the sample rate and reallocate the delay lines
+   *
+   * Allocates; call before audio starts, never from the audio thread.
+   *
+   * @param sampleRate Sample rate in Hz
+   */
+  void prepare(double sampleRate) {
+    samplesPerMs_ = sampleRate / 1000.0;
+    size_t maxSamples = static_cast<size_t>(maxDelayMs_ * samplesPerMs_);
+    bufferL_.assign(maxSamples, 0.0);
+    bufferR_.assign(maxSamples, 0.0);
+    writePos_ = 0;
     updateDelaySamples();
   }
 
@@ -70,6 +86,47 @@ public:
     writePos_ = (writePos_ + 1) % bufferL_.size();
   }
 
+  /**
+   * @brief Process a block of stereo samples in place
+   *
+   * Same output as calling process() per sample, with both ring indices
+   * wrapped by comparison instead of a modulo.
+   */
+  void processBlock(Sample *left, Sample *right, int numSamples) {
+    const size_t size = bufferL_.size();
+    const Parameter dry = 1.0 - mix_;
+    size_t writePos = writePos_;
+    size_t readPos = (writePos + size - delaySamples_) % size;
+
+    for (int i = 0; i < numSamples; ++i) {
+      Sample delayedL = bufferL_[readPos];
+      Sample delayedR = bufferR_[readPos];
+
+      bufferL_[writePos] = left[i] + delayedL * feedback_;
+      bufferR_[writePos] = right[i] + delayedR * feedback_;
+
+      left[i] = left[i] * dry + delayedL * mix_;
+      right[i] = right[i] * dry + delayedR * mix_;
+
+      if (++writePos == size)
+        writePos = 0;
+      if (++readPos == size)
+        readPos = 0;
+    }
+    writePos_ = writePos;
+  }
+
+  /**
+   * @brief Samples until the echoes decay below -100 dB after input stops
+   */
+  size_t getTailSamples() const {
+    size_t repeats = 1;
+    if (feedback_ > 0.0)
+      repeats += static_cast<size_t>(std::ceil(std::log(1e-5) /
+                                               std::log(feedback_)));
+    return (delaySamples_ + 1) * repeats;
+  }
+
   /**
    * @brief Clear delay buffers
    */
@@ -78,16 +135,26 @@ public:
     std::fill(bufferR_.begin(), bufferR_.end(), 0.0);
   }
 
+  /**
+   * @brief clear() in slices (see clearBuffersPartial)
+   * @return true once the buffers are clear
+   */
+  bool clearPartial(size_t &pos, size_t maxSamples) {
+    return clearBuffersPartial({&bufferL_, &bufferR_}, pos, maxSamples);
+  }
+
 private:
   std::vector<Sample> bufferL_, bufferR_;
   size_t writePos_;
   size_t delaySamples_;
   double delayTime_;
+  double maxDelayMs_;
+  double samplesPerMs_;
   Parameter feedback_;
   Parameter mix_;
 
   void updateDelaySamples() {
-    delaySamples_ = static_cast<size_t>(delayTime_ * SAMPLE_RATE / 1000.0);
+    delaySamples_ = static_cast<size_t>(delayTime_ * samplesPerMs_);
     delaySamples_ = std::min(delaySamples_, bufferL_.size() - 1);
   }
 };
@@ -0,0 +1,162 @@
+#pragma once
+/**
+ * @file effects_bus.hpp
+ * @brief Stereo effects chain: Chorus -> Delay -> Reverb
+ */
+
+#include "../core/types.hpp"
+#include "chorus.hpp"
+#include "delay.hpp"
+#include "reverb.hpp"
+#include <cstddef>
+
+namespace synth {
+
+/**
+ * @class EffectsBus
+ * @brief Serial master effects with per-effect bypass
+ *
+ * A bypassed effect is skipped entirely. An enabled effect whose input has
+ * been silent for longer than its tail is skipped as well, so an idle
+ * synth spends no cycles in the chain. Re-enabling an effect clears its
+ * buffers so stale echoes from before the bypass never play: a slice per
+ * block (CLEAR_SAMPLES_PER_FRAME per frame rendered), so a bypass toggle
+ * never stalls the audio thread. The effect stays bypassed until its
+ * buffers are clear: about 60 ms for the 2 s delay line at 48 kHz.
+ */
+class EffectsBus {
+public:
+  EffectsBus() { prepare(DEFAULT_SAMPLE_RATE); }
+
+  /**
+   * @brief Set the sample rate for every effect
+   *
+   * Allocates; call before audio starts, never from the audio thread.
+   *
+   * @param sampleRate Sample rate in Hz
+   */
+  void prepare(double sampleRate) {
+    chorus_.prepare(sampleRate);
+    delay_.prepare(sampleRate);
+    reverb_.prepare(sampleRate);
+    for (auto &slot : slots_) {
+      slot.tailRemaining = 0;
+      slot.clearing = false;
+    }
+  }
+
+  // ==================== Bypass ====================
+
+  void setChorusEnabled(bool on) { setEnabled(CHORUS, on); }
+  void setDelayEnabled(bool on) { setEnabled(DELAY, on); }
+  void setReverbEnabled(bool on) { setEnabled(REVERB, on); }
+
+  bool isChorusEnabled() const { return slots_[CHORUS].enabled; }
+  bool isDelayEnabled() const { return slots_[DELAY].enabled; }
+  bool isReverbEnabled() const { return slots_[REVERB].enabled; }
+
+  // ==================== Effect Parameters ====================
+
+  Chorus &chorus() { return chorus_; }
+  Delay &delay() { return delay_; }
+  Reverb &reverb() { return reverb_; }
+
+  // ==================== Audio Processing ====================
+
+  /**
+   * @brief Run the chain over a block in place
+   * @param left Left channel (in/out)
+   * @param right Right channel (in/out)
+   * @param numSamples Block length
+   * @param inputSilent True when the block is known to be all zeros
+   */
+  void processBlock(Sample *left, Sample *right, int numSamples,
+                    bool inputSilent) {
+    bool silent = inputSilent;
+    silent = runSlot(CHORUS, chorus_, left, right, numSamples, silent);
+    silent = runSlot(DELAY, delay_, left, right, numSamples, silent);
+    runSlot(REVERB, reverb_, left, right, numSamples, silent);
+  }
+
+  /**
+   * @brief Run the chain on one frame (per-sample path, no idle skipping)
+   */
+  void processFrame(Sample &left, Sample &right) {
+    if (isReady(CHORUS, chorus_, 1))
+      chorus_.process(left, right);
+    if (isReady(DELAY, delay_, 1))
+      delay_.process(left, right);
+    if (isReady(REVERB, reverb_, 1))
+      reverb_.process(left, right);
+  }
+
+private:
+  enum SlotIndex { CHORUS, DELAY, REVERB, NUM_SLOTS };
+
+  /** @brief Buffer samples cleared per frame rendered while re-enabling */
+  static constexpr size_t CLEAR_SAMPLES_PER_FRAME = 64;
+
+  struct Slot {
+    bool enabled = false;
+    bool clearing = false;    // Buffers still being zeroed (see isReady)
+    size_t clearPos = 0;      // Progress of that clear
+    size_t tailRemaining = 0; // Samples of output left after input stopped
+  };
+
+  Chorus chorus_;
+  Delay delay_;
+  Reverb reverb_;
+  Slot slots_[NUM_SLOTS];
+
+  void setEnabled(SlotIndex index, bool on) {
+    Slot &slot = slots_[index];
+    if (on && !slot.enabled) {
+      slot.clearing = true;
+      slot.clearPos = 0;
+      slot.tailRemaining = 0;
+    }
+    slot.enabled = on;
+  }
+
+  /**
+   * @brief Whether an enabled effect may run, advancing a pending clear
+   * @param numFrames Frames about to be rendered, sets the clear budget
+   */
+  template <typename Effect>
+  bool isReady(SlotIndex index, Effect &fx, int numFrames) {
+    Slot &slot = slots_[index];
+    if (!slot.enabled)
+      return false;
+    if (slot.clearing)
+      slot.clearing = !fx.clearPartial(
+          slot.clearPos,
+          CLEAR_SAMPLES_PER_FRAME * static_cast<size_t>(numFrames));
+    return !slot.clearing;
+  }
+
+  /**
+   * @brief Process one effect if it can produce output
+   * @return Whether this stage's output is silent
+   */
+  template <typename Effect>
+  bool runSlot(SlotIndex index, Effect &fx, Sample *left, Sample *right,
+               int numSamples, bool inputSilent) {
+    Slot &slot = slots_[index];
+    if (!isReady(index, fx, numSamples))
+      return inputSilent;
+
+    const size_t n = static_cast<size_t>(numSamples);
+    if (inputSilent) {
+      if (slot.tailRemaining == 0)
+        return true;
+      slot.tailRemaining = slot.tailRemaining > n ? slot.tailRemaining - n : 0;
+    } else {
+      slot.tailRemaining = fx.getTailSamples();
+    }
+
+    fx.processBlock(left, right, numSamples);
+    return false;
+  }
+};
+
+} // namespace synth
@@ -5,6 +5,7 @@
  */
 
 #include "../core/types.hpp"
+#include "buffer_clear.hpp"
 #include <algorithm>
 #include <array>
 #include <cmath>
@@ -19,19 +20,32 @@ namespace synth {
 class Reverb {
 public:
   Reverb() : mix_(0.3), decay_(0.5) {
+    prepare(DEFAULT_SAMPLE_RATE);
+    updateDecay();
+  }
+
+  /**
+   * @brief Set the sample rate and reallocate the comb/allpass lines
+   *
+   * Delay lengths are tuned at 48 kHz and scaled to the actual rate so the
+   * room sounds the same at any rate. Allocates; call before audio starts.
+   *
+   * @param sampleRate Sample rate in Hz
+   */
+  void prepare(double sampleRate) {
+    const double scale = sampleRate / 48000.0;
+
     const std::array<size_t, 4> combDelays = {2999, 3407, 3701, 4003};
     for (size_t i = 0; i < 4; ++i) {
-      combBuffers_[i].resize(combDelays[i] * 4, 0.0);
+      combBuffers_[i].assign(scaledLength(combDelays[i], scale), 0.0);
       combPos_[i] = 0;
     }
 
     const std::array<size_t, 2> apDelays = {521, 337};
     for (size_t i = 0; i < 2; ++i) {
-      apBuffers_[i].resize(apDelays[i] * 4, 0.0);
+      apBuffers_[i].assign(scaledLength(apDelays[i], scale), 0.0);
       apPos_[i] = 0;
     }
-
-    updateDecay();
   }
 
   /**
@@ -72,6 +86,88 @@ public:
     right = right * (1.0 - mix_) + apOut * mix_;
   }
 
+  /**
+   * @brief Process a block of stereo samples in place
+   *
+   * Runs each comb and allpass over the whole chunk in turn, so every
+   * delay line stays hot in cache for its inner loop. Output matches
+   * calling process() per sample.
+   */
+  void processBlock(Sample *left, Sample *right, int numSamples) {
+    Sample input[MAX_BLOCK_SIZE];
+    Sample wet[MAX_BLOCK_SIZE];
+    const Parameter dry = 1.0 - mix_;
+
+    while (numSamples > 0) {
+      int n = std::min(numSamples, MAX_BLOCK_SIZE);
+
+      for (int i = 0; i < n; ++i) {
+        input[i] = (left[i] + right[i]) * 0.5;
+        wet[i] = 0.0;
+      }
+
+      for (size_t c = 0; c < 4; ++c) {
+        Sample *buffer = combBuffers_[c].data();
+        const size_t size = combBuffers_[c].size();
+        const Sample fb = combFeedback_[c];
+        size_t pos = combPos_[c];
+        for (int i = 0; i < n; ++i) {
+          Sample out = buffer[pos];
+          buffer[pos] = input[i] + out * fb;
+          wet[i] += out;
+          if (++pos == size)
+            pos = 0;
+        }
+        combPos_[c] = pos;
+      }
+      for (int i = 0; i < n; ++i)
+        wet[i] *= 0.25;
+
+      for (size_t a = 0; a < 2; ++a) {
+        Sample *buffer = apBuffers_[a].data();
+        const size_t size = apBuffers_[a].size();
+        const Sample g = 0.7;
+        size_t pos = apPos_[a];
+        for (int i = 0; i < n; ++i) {
+          Sample in = wet[i];
+          Sample delayed = buffer[pos];
+          wet[i] = -g * in + delayed;
+          buffer[pos] = in + g * delayed;
+          if (++pos == size)
+            pos = 0;
+        }
+        apPos_[a] = pos;
+      }
+
+      for (int i = 0; i < n; ++i) {
+        left[i] = left[i] * dry + wet[i] * mix_;
+        right[i] = right[i] * dry + wet[i] * mix_;
+      }
+
+      left += n;
+      right += n;
+      numSamples -= n;
+    }
+  }
+
+  /**
+   * @brief Samples until the tail decays below -100 dB after input stops
+   */
+  size_t getTailSamples() const {
+    size_t tail = 0;
+    for (size_t i = 0; i < 4; ++i) {
+      size_t repeats = 1;
+      if (combFeedback_[i] > 0.0)
+        repeats += static_cast<size_t>(std::ceil(std::log(1e-5) /
+                                                 std::log(combFeedback_[i])));
+      tail = std::max(tail, combBuffers_[i].size() * repeats);
+    }
+    // Allpass g = 0.7 rings for ~32 passes before reaching -100 dB
+    for (size_t i = 0; i < 2; ++i)
+      tail += apBuffers_[i].size() * 32;
+    return tail;
+  }
+
   /**
    * @brief Clear all buffers
    */
@@ -82,6 +178,17 @@ public:
       std::fill(buf.begin(), buf.end(), 0.0);
   }
 
+  /**
+   * @brief clear() in slices (see clearBuffersPartial)
+   * @return true once the buffers are clear
+   */
+  bool clearPartial(size_t &pos, size_t maxSamples) {
+    return clearBuffersPartial({&combBuffers_[0], &combBuffers_[1],
+                                &combBuffers_[2], &combBuffers_[3],
+                                &apBuffers_[0], &apBuffers_[1]},
+                               pos, maxSamples);
+  }
+
 private:
   std::array<std::vector<Sample>, 4> combBuffers_;
   std::array<size_t, 4> combPos_;
@@ -93,6 +200,10 @@ private:
   Parameter mix_;
   Parameter decay_;
 
+  static size_t scaledLength(size_t samplesAt48k, double scale) {
+    return std::max<size_t>(1, static_cast<size_t>(samplesAt48k * scale));
+  }
+
   void updateDecay() {
     combFeedback_[0] = 0.805 * decay_;
     combFeedback_[1] = 0.827 * decay_;
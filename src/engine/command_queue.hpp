@@ -0,0 +1,187 @@
+#pragma once
+/**
+ * @file command_queue.hpp
+ * @brief Wait-free single-producer/single-consumer command ring
+ *
+ * Carries timestamped engine commands from the UI thread to the audio
+ * callback without locks or allocation. The audio thread drains it at the
+ * start of each block and applies each command at its sample offset.
+ */
+
+#include "../core/oscillator.hpp"
+#include "../core/types.hpp"
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+namespace synth {
+
+/**
+ * @struct EngineCommand
+ * @brief One parameter or note event for the engine
+ *
+ * sampleTime is in engine frames (see SynthEngine::getSampleTime()).
+ * Commands stamped in the past, including the default 0, apply at the
+ * start of the next block.
+ */
+struct EngineCommand {
+  enum class Type {
+    NOTE_ON,
+    NOTE_OFF,
+    ALL_NOTES_OFF,
+    LOAD_PRESET,
+    SET_WAVE_MIX,
+    SET_OSC2_PITCH, // Semitones
+    SET_OSC_SYNC,   // value > 0.5 enables
+    SET_RING_MOD,   // value > 0.5 enables
+    SET_CROSS_MOD,
+    SET_UNISON_VOICES,
+    SET_UNISON_DETUNE,
+    SET_UNISON_SPREAD,
+    SET_MULTI_LEVEL,
+    SET_MULTI_MODE,  // 0 = VPM, 1 = WAVES, 2 = NOISE, 3 = ADDITIVE
+    SET_MULTI_SHAPE, // WAVES frame position
+    SET_WAVE_TABLE,  // 0-based user table
+    SET_FM_ALGORITHM, // 1-based, as printed on the panel
+    SET_FILTER_CUTOFF,
+    SET_FILTER_RESONANCE,
+    SET_FILTER_DRIVE,
+    SET_FILTER_TYPE, // 0 = SVF, 1 = ladder, 2 = ZDF
+    SET_AMP_ATTACK,
+    SET_AMP_DECAY,
+    SET_AMP_SUSTAIN,
+    SET_AMP_RELEASE,
+    SET_MASTER_VOLUME,
+    SET_CHORUS_ENABLED, // value > 0.5 enables
+    SET_CHORUS_RATE,
+    SET_CHORUS_DEPTH,
+    SET_CHORUS_MIX,
+    SET_DELAY_ENABLED,
+    SET_DELAY_TIME,
+    SET_DELAY_FEEDBACK,
+    SET_DELAY_MIX,
+    SET_REVERB_ENABLED,
+    SET_REVERB_DECAY,
+    SET_REVERB_MIX
+  };
+
+  Type type = Type::ALL_NOTES_OFF;
+  uint64_t sampleTime = 0;
+  int note = 0;       // Note number or preset index
+  double value = 0.0; // Velocity or parameter value
+  WaveMix waveMix;
+
+  static EngineCommand noteOn(int note, double velocity,
+                              uint64_t sampleTime = 0) {
+    EngineCommand c;
+    c.type = Type::NOTE_ON;
+    c.sampleTime = sampleTime;
+    c.note = note;
+    c.value = velocity;
+    return c;
+  }
+
+  static EngineCommand noteOff(int note, uint64_t sampleTime = 0) {
+    EngineCommand c;
+    c.type = Type::NOTE_OFF;
+    c.sampleTime = sampleTime;
+    c.note = note;
+    return c;
+  }
+
+  static EngineCommand allNotesOff(uint64_t sampleTime = 0) {
+    EngineCommand c;
+    c.type = Type::ALL_NOTES_OFF;
+    c.sampleTime = sampleTime;
+    return c;
+  }
+
+  static EngineCommand loadPreset(int index, uint64_t sampleTime = 0) {
+    EngineCommand c;
+    c.type = Type::LOAD_PRESET;
+    c.sampleTime = sampleTime;
+    c.note = index;
+    return c;
+  }
+
+  static EngineCommand setWaveMix(const WaveMix &mix,
+                                  uint64_t sampleTime = 0) {
+    EngineCommand c;
+    c.type = Type::SET_WAVE_MIX;
+    c.sampleTime = sampleTime;
+    c.waveMix = mix;
+    return c;
+  }
+
+  static EngineCommand setParameter(Type type, double value,
+                                    uint64_t sampleTime = 0) {
+    EngineCommand c;
+    c.type = type;
+    c.sampleTime = sampleTime;
+    c.value = value;
+    return c;
+  }
+};
+
+/**
+ * @class SpscQueue
+ * @brief Bounded lock-free ring for exactly one producer and one consumer
+ *
+ * push() is only called from the producer thread; front()/pop() only from
+ * the consumer. Capacity must be a power of two; one slot is kept free.
+ */
+template <typename T, size_t Capacity> class SpscQueue {
+  static_assert((Capacity & (Capacity - 1)) == 0,
+                "Capacity must be a power of two");
+
+public:
+  /**
+   * @brief Enqueue an item (producer thread)
+   * @return false if the queue is full and the item was dropped
+   */
+  bool push(const T &item) {
+    size_t tail = tail_.load(std::memory_order_relaxed);
+    size_t next = (tail + 1) & MASK;
+    if (next == head_.load(std::memory_order_acquire))
+      return false;
+    buffer_[tail] = item;
+    tail_.store(next, std::memory_order_release);
+    return true;
+  }
+
+  /**
+   * @brief Peek at the oldest item (consumer thread)
+   * @return Pointer to the item, or nullptr if empty
+   */
+  const T *front() const {
+    size_t head = head_.load(std::memory_order_relaxed);
+    if (head == tail_.load(std::memory_order_acquire))
+      return nullptr;
+    return &buffer_[head];
+  }
+
+  /**
+   * @brief Discard the oldest item (consumer thread, after front())
+   */
+  void pop() {
+    size_t head = head_.load(std::memory_order_relaxed);
+    head_.store((head + 1) & MASK, std::memory_order_release);
+  }
+
+  bool empty() const {
+    return head_.load(std::memory_order_acquire) ==
+           tail_.load(std::memory_order_acquire);
+  }
+
+private:
+  static constexpr size_t MASK = Capacity - 1;
+
+  std::array<T, Capacity> buffer_;
+  alignas(64) std::atomic<size_t> head_{0};
+  alignas(64) std::atomic<size_t> tail_{0};
+};
+
+using CommandQueue = SpscQueue<EngineCommand, 1024>;
+
+} // namespace synth
@@ -0,0 +1,616 @@
+#pragma once
+/**
+ * @file simd_synth_engine.hpp
+ * @brief Voice-parallel 4-voice engine with structure-of-arrays state
+ *
+ * Alternative to SynthEngine that stores every voice's oscillator, filter
+ * and envelope state in SoA form, one voice per SIMD lane. Each Float4
+ * operation advances all four voices at once: phases, PolyBLEP
+ * corrections, the filters (a FilterBank) and the envelope recursions.
+ *
+ * The signal path matches Voice: 2 mixing oscillators + FM multi engine ->
+ * SVF or ladder with drive -> VCA, with envelopes, LFO and cutoff
+ * evaluated at control rate. Audio is computed in single precision. The
+ * FM operators run the same kernel as FmEngine, instantiated for Float4
+ * lanes. VPM is the only multi engine mode: in any other mode the multi
+ * engine is silent, so presets built on WAVES, NOISE or ADDITIVE play
+ * their oscillators alone.
+ */
+
+#include "../core/cutoff_table.hpp"
+#include "../core/filter_bank.hpp"
+#include "../core/fm_engine.hpp"
+#include "../core/lfo.hpp"
+#include "../core/noise.hpp"
+#include "../core/presets.hpp"
+#include "../core/simd.hpp"
+#include "../core/types.hpp"
+#include <algorithm>
+#include <array>
+#include <cstdint>
+
+namespace synth {
+
+/**
+ * @class SimdSynthEngine
+ * @brief 4-voice polyphonic engine rendering all voices in SIMD lanes
+ */
+class SimdSynthEngine {
+public:
+  static constexpr int MAX_VOICES = SIMD_WIDTH;
+
+  int getPolyphony() const { return MAX_VOICES; }
+
+  SimdSynthEngine() {
+    for (int v = 0; v < MAX_VOICES; ++v) {
+      phase1_[v] = phase2_[v] = 0.0f;
+      inc1_[v] = inc2_[v] = invInc1_[v] = invInc2_[v] = 0.0f;
+      velocity_[v] = 0.0f;
+      notes_[v] = 0;
+    }
+    ampEnv_.reset();
+    filterEnv_.reset();
+    for (auto &env : fmEnv_)
+      env.reset();
+
+    loadPreset(0);
+    lfo_.setRate(2.0);
+    lfo_.setShape(LFO::Shape::TRIANGLE);
+  }
+
+  /**
+   * @brief Configure the engine for the device sample rate
+   *
+   * Call before audio starts, never from the audio thread. Held notes keep
+   * their old pitch until retriggered.
+   *
+   * @param sampleRate Sample rate in Hz
+   */
+  void prepare(double sampleRate) {
+    sampleRate_ = sampleRate;
+    filters_.prepare(sampleRate);
+    ampEnv_.prepare(sampleRate);
+    filterEnv_.prepare(sampleRate);
+    for (auto &env : fmEnv_)
+      env.prepare(sampleRate);
+    setFmIncrements();
+    lfo_.prepare(sampleRate);
+  }
+
+  double getSampleRate() const { return sampleRate_; }
+
+  // ==================== Note Control ====================
+
+  /**
+   * @brief Trigger note on
+   * @param note MIDI note number
+   * @param velocity Note velocity (0.0 to 1.0)
+   */
+  void noteOn(int note, double velocity = 1.0) {
+    int lane = 0; // Simple steal
+    for (int v = 0; v < MAX_VOICES; ++v) {
+      if (!isLaneActive(v)) {
+        lane = v;
+        break;
+      }
+    }
+
+    Frequency baseFreq = midiToFrequency(note);
+    setLaneIncrement(inc1_, invInc1_, lane, baseFreq);
+    setLaneIncrement(inc2_, invInc2_, lane, baseFreq * 1.002);
+    notes_[lane] = note;
+    velocity_[lane] = static_cast<float>(velocity);
+    filters_.reset(lane);
+    ampEnv_.noteOn(lane);
+    filterEnv_.noteOn(lane);
+    setFmLane(lane);
+  }
+
+  /**
+   * @brief Trigger note off
+   * @param note MIDI note number
+   */
+  void noteOff(int note) {
+    for (int v = 0; v < MAX_VOICES; ++v) {
+      if (isLaneActive(v) && notes_[v] == note) {
+        ampEnv_.noteOff(v);
+        filterEnv_.noteOff(v);
+        for (auto &env : fmEnv_)
+          env.noteOff(v);
+      }
+    }
+  }
+
+  /**
+   * @brief Release all notes
+   */
+  void allNotesOff() {
+    for (int v = 0; v < MAX_VOICES; ++v) {
+      ampEnv_.noteOff(v);
+      filterEnv_.noteOff(v);
+      for (auto &env : fmEnv_)
+        env.noteOff(v);
+    }
+  }
+
+  // ==================== Preset System ====================
+
+  void loadPreset(int index) {
+    if (index < 0 || index >= PresetBank::NUM_PRESETS)
+      return;
+
+    currentPreset_ = index;
+    applyPreset(PresetBank::getPreset(index));
+  }
+
+  void applyPreset(const SynthPreset &preset) {
+    setWaveMix(preset.waveMix);
+    setMultiMode(preset.multiMode);
+    setMultiLevel(preset.multiLevel);
+    setFmPatch(preset.fmPatch);
+    setFilterType(preset.filterType);
+    setFilterCutoff(preset.filterCutoff);
+    setFilterResonance(preset.filterResonance);
+    setFilterDrive(preset.filterDrive);
+    setAmpADSR(preset.ampAttack, preset.ampDecay, preset.ampSustain,
+               preset.ampRelease);
+    setFilterADSR(preset.filterAttack, preset.filterDecay,
+                  preset.filterSustain, preset.filterRelease);
+    setFilterEnvDepth(preset.filterEnvDepth);
+    masterVolume_ = preset.masterVolume;
+  }
+
+  int getCurrentPreset() const { return currentPreset_; }
+  const char *getCurrentPresetName() const {
+    return PresetBank::getPresetName(currentPreset_);
+  }
+
+  // ==================== Parameters ====================
+
+  void setWaveMix(const WaveMix &mix) {
+    osc1Mix_.set(mix);
+    osc2Mix_.set(mix);
+  }
+
+  void setWaveMix(Parameter sine, Parameter tri, Parameter saw, Parameter sqr,
+                  Parameter noise = 0.0) {
+    WaveMix mix;
+    mix.sine = sine;
+    mix.triangle = tri;
+    mix.sawtooth = saw;
+    mix.square = sqr;
+    mix.noise = noise;
+    setWaveMix(mix);
+  }
+
+  void setMultiLevel(Parameter level) {
+    multiLevel_ = static_cast<float>(std::clamp(level, 0.0, 1.0));
+  }
+
+  /**
+   * @brief Select the multi engine mode; only VPM sounds (see file doc)
+   */
+  void setMultiMode(MultiEngine::Mode mode) { multiMode_ = mode; }
+
+  void setFmPatch(const FmPatch &patch) {
+    fmPatch_ = patch;
+    fmKernel_ = fmKernel<Float4>(patch.algorithm);
+    double scale[FM_OPERATORS];
+    fmOperatorScales(patch, 1.0, scale);
+    for (int k = 0; k < FM_OPERATORS; ++k) {
+      const FmOperatorParams &op = patch.op[k];
+      fmEnv_[k].set(op.attack, op.decay, op.sustain, op.release);
+      fmScale_[k] = static_cast<float>(scale[k]);
+    }
+    fm_.feedback = static_cast<float>(std::clamp(patch.feedback, 0.0, 1.0) *
+                                      FM_MAX_FEEDBACK_CYCLES * 0.5);
+    setFmIncrements();
+  }
+
+  void setFilterCutoff(Frequency f) {
+    basePitch_ = cutoffToPitch(std::max(f, MIN_CUTOFF));
+  }
+
+  void setFilterResonance(Parameter r) { filters_.setResonance(r); }
+  void setFilterDrive(Parameter d) { filters_.setDrive(d); }
+  void setFilterMode(FilterMode m) { filters_.setMode(m); }
+
+  /**
+   * @brief SVF or LADDER; ZDF runs as SVF (see FilterBank::setType)
+   */
+  void setFilterType(FilterType type) { filters_.setType(type); }
+
+  void setAmpADSR(double a, double d, Parameter s, double r) {
+    ampEnv_.set(a, d, s, r);
+  }
+
+  void setFilterADSR(double a, double d, Parameter s, double r) {
+    filterEnv_.set(a, d, s, r);
+  }
+
+  void setFilterEnvDepth(Parameter depth) { filterEnvDepth_ = depth; }
+  void setOscMix(Parameter mix) { oscMix_ = static_cast<float>(mix); }
+
+  void setLfoRate(Frequency hz) { lfo_.setRate(hz); }
+  void setLfoShape(LFO::Shape s) { lfo_.setShape(s); }
+  /** @brief LFO -> cutoff depth, in octaves at full LFO swing */
+  void setLfoDepth(Parameter depth) { lfoDepth_ = depth; }
+
+  void setMasterVolume(Parameter vol) { masterVolume_ = vol; }
+
+  // ==================== Audio Processing ====================
+
+  /**
+   * @brief Render a block of stereo samples
+   * @param left Left channel output (frames long)
+   * @param right Right channel output (frames long)
+   * @param frames Number of frames to render
+   */
+  void processBlock(float *left, float *right, uint32_t frames) {
+    const float gain = static_cast<float>(masterVolume_ * 0.5);
+
+    uint32_t pos = 0;
+    while (pos < frames) {
+      int len = static_cast<int>(std::min<uint32_t>(
+          frames - pos, static_cast<uint32_t>(CONTROL_BLOCK_SIZE)));
+      Sample lfoVal = lfo_.advance(len) * lfoDepth_;
+
+      if (ampEnv_.anyActive()) {
+        renderControlBlock(left + pos, len, lfoVal, gain);
+      } else {
+        std::fill(left + pos, left + pos + len, 0.0f);
+      }
+      std::copy(left + pos, left + pos + len, right + pos);
+      pos += static_cast<uint32_t>(len);
+    }
+  }
+
+private:
+  /**
+   * @brief Envelope generators for all lanes (control rate only)
+   *
+   * Each lane keeps its own level and stage; the per-stage target and
+   * coefficient are cached per lane so one vector update advances every
+   * voice, with scalar fix-ups only on stage transitions.
+   */
+  struct AdsrLanes {
+    enum Stage { IDLE, ATTACK, DECAY, SUSTAIN, RELEASE };
+
+    alignas(16) float level[MAX_VOICES];
+    alignas(16) float target[MAX_VOICES];
+    alignas(16) float coef[MAX_VOICES];
+    int stage[MAX_VOICES];
+
+    float sustain = 0.7f;
+    double attackTime = 0.01, decayTime = 0.1, releaseTime = 0.3;
+    double attackCoef = 0.0, decayCoef = 0.0, releaseCoef = 0.0;
+    double sampleRate = DEFAULT_SAMPLE_RATE;
+
+    void reset() {
+      for (int v = 0; v < MAX_VOICES; ++v) {
+        level[v] = 0.0f;
+        enter(v, IDLE);
+      }
+    }
+
+    void prepare(double rate) {
+      sampleRate = rate;
+      updateCoefficients();
+    }
+
+    void set(double a, double d, Parameter s, double r) {
+      sustain = static_cast<float>(std::clamp(s, 0.0, 1.0));
+      attackTime = std::clamp(a, 0.001, 10.0);
+      decayTime = std::clamp(d, 0.001, 10.0);
+      releaseTime = std::clamp(r, 0.001, 10.0);
+      updateCoefficients();
+    }
+
+    void noteOn(int v) { enter(v, ATTACK); }
+
+    void noteOff(int v) {
+      if (stage[v] != IDLE)
+        enter(v, RELEASE);
+    }
+
+    bool isActive(int v) const { return stage[v] != IDLE; }
+
+    bool anyActive() const {
+      for (int v = 0; v < MAX_VOICES; ++v)
+        if (stage[v] != IDLE)
+          return true;
+      return false;
+    }
+
+    /**
+     * @brief Advance all lanes by numSamples and return the new levels
+     */
+    Float4 advance(int numSamples) {
+      Float4 lvl = Float4::load(level);
+      Float4 c = Float4::load(coef);
+      if (numSamples != CONTROL_BLOCK_SIZE) {
+        alignas(16) float partial[MAX_VOICES];
+        for (int v = 0; v < MAX_VOICES; ++v)
+          partial[v] = static_cast<float>(
+              1.0 - std::pow(1.0 - coef[v],
+                             static_cast<double>(numSamples) /
+                                 CONTROL_BLOCK_SIZE));
+        c = Float4::load(partial);
+      }
+      lvl = lvl + c * (Float4::load(target) - lvl);
+      lvl.store(level);
+
+      for (int v = 0; v < MAX_VOICES; ++v) {
+        switch (stage[v]) {
+        case ATTACK:
+          if (level[v] >= 1.0f) {
+            level[v] = 1.0f;
+            enter(v, DECAY);
+          }
+          break;
+        case DECAY:
+          if (level[v] <= sustain + 0.001f) {
+            level[v] = sustain;
+            enter(v, SUSTAIN);
+          }
+          break;
+        case RELEASE:
+          if (level[v] <= 0.001f) {
+            level[v] = 0.0f;
+            enter(v, IDLE);
+          }
+          break;
+        default:
+          break;
+        }
+      }
+      return Float4::load(level);
+    }
+
+  private:
+    double samplesCoef(double seconds) const {
+      return 1.0 - std::exp(-2.2 * CONTROL_BLOCK_SIZE / (seconds * sampleRate));
+    }
+
+    void updateCoefficients() {
+      attackCoef = samplesCoef(attackTime);
+      decayCoef = samplesCoef(decayTime);
+      releaseCoef = samplesCoef(releaseTime);
+      for (int v = 0; v < MAX_VOICES; ++v)
+        enter(v, stage[v]);
+    }
+
+    void enter(int v, int s) {
+      stage[v] = s;
+      switch (s) {
+      case ATTACK:
+        target[v] = 1.3f;
+        coef[v] = static_cast<float>(attackCoef);
+        break;
+      case DECAY:
+        target[v] = sustain;
+        coef[v] = static_cast<float>(decayCoef);
+        break;
+      case SUSTAIN:
+        target[v] = sustain;
+        coef[v] = 1.0f;
+        break;
+      case RELEASE:
+        target[v] = 0.0f;
+        coef[v] = static_cast<float>(releaseCoef);
+        break;
+      default:
+        target[v] = 0.0f;
+        coef[v] = 1.0f;
+        break;
+      }
+    }
+  };
+
+  /**
+   * @brief Normalized waveform gains for one oscillator (shared by lanes)
+   */
+  struct MixGains {
+    float sine = 0.0f, triangle = 0.0f, sawtooth = 1.0f, square = 0.0f,
+          noise = 0.0f;
+
+    void set(const WaveMix &mix) {
+      double total =
+          mix.sine + mix.triangle + mix.sawtooth + mix.square + mix.noise;
+      double norm = (total > 0.0) ? 1.0 / total : 0.0;
+      sine = static_cast<float>(mix.sine * norm);
+      triangle = static_cast<float>(mix.triangle * norm);
+      sawtooth = static_cast<float>(mix.sawtooth * norm);
+      square = static_cast<float>(mix.square * norm);
+      noise = static_cast<float>(mix.noise * norm);
+    }
+  };
+
+  // Oscillator state
+  alignas(16) float phase1_[MAX_VOICES];
+  alignas(16) float phase2_[MAX_VOICES];
+  alignas(16) float inc1_[MAX_VOICES];
+  alignas(16) float inc2_[MAX_VOICES];
+  alignas(16) float invInc1_[MAX_VOICES];
+  alignas(16) float invInc2_[MAX_VOICES];
+  NoiseGenerator noise_{1u}; // One register per lane
+  MixGains osc1Mix_, osc2Mix_;
+
+  // FM multi engine: one voice per lane, operators share the kernel with
+  // FmEngine
+  FmLanes<Float4> fm_;
+  AdsrLanes fmEnv_[FM_OPERATORS];
+  FmPatch fmPatch_;
+  FmKernel<Float4> fmKernel_ = fmKernel<Float4>(0);
+  float fmScale_[FM_OPERATORS] = {};
+  float multiLevel_ = 0.0f;
+  MultiEngine::Mode multiMode_ = MultiEngine::Mode::VPM;
+  const float *sineTable_ = WavetableBank::instance().sine();
+  float oscMix_ = 0.5f;
+
+  // Filters, one lane per voice
+  FilterBank<MAX_VOICES> filters_;
+  double basePitch_ = cutoffToPitch(2000.0); // Cutoff, log2(Hz)
+  Parameter filterEnvDepth_ = 0.5;
+
+  // Envelopes and per-voice note data
+  AdsrLanes ampEnv_, filterEnv_;
+  alignas(16) float velocity_[MAX_VOICES];
+  int notes_[MAX_VOICES];
+
+  LFO lfo_;
+  Parameter lfoDepth_ = 0.2;
+  Parameter masterVolume_ = 0.8;
+  int currentPreset_ = 0;
+
+  double sampleRate_ = DEFAULT_SAMPLE_RATE;
+
+  bool isLaneActive(int v) const { return ampEnv_.isActive(v); }
+
+  void setLaneIncrement(float *inc, float *invInc, int lane,
+                        Frequency freq) const {
+    double dt = frequencyToPhaseIncrement(freq, sampleRate_);
+    inc[lane] = static_cast<float>(dt);
+    invInc[lane] = (dt > 0.0) ? static_cast<float>(1.0 / dt) : 0.0f;
+  }
+
+  static void setLaneValue(Float4 &v, int lane, float x) {
+    alignas(16) float values[MAX_VOICES];
+    v.store(values);
+    values[lane] = x;
+    v = Float4::load(values);
+  }
+
+  /**
+   * @brief Operator increments for every lane's current note
+   */
+  void setFmIncrements() {
+    for (int k = 0; k < FM_OPERATORS; ++k) {
+      alignas(16) float inc[MAX_VOICES];
+      for (int v = 0; v < MAX_VOICES; ++v)
+        inc[v] = static_cast<float>(frequencyToPhaseIncrement(
+            midiToFrequency(notes_[v]) * fmPatch_.op[k].ratio, sampleRate_));
+      fm_.increment[k] = Float4::load(inc);
+    }
+  }
+
+  /**
+   * @brief Restart the FM operators of one lane on note-on
+   */
+  void setFmLane(int lane) {
+    for (int k = 0; k < FM_OPERATORS; ++k) {
+      setLaneValue(fm_.phase[k], lane, 0.0f);
+      setLaneValue(fm_.increment[k], lane,
+                   static_cast<float>(frequencyToPhaseIncrement(
+                       midiToFrequency(notes_[lane]) * fmPatch_.op[k].ratio,
+                       sampleRate_)));
+      fmEnv_[k].noteOn(lane);
+    }
+    setLaneValue(fm_.history[0], lane, 0.0f);
+    setLaneValue(fm_.history[1], lane, 0.0f);
+  }
+
+  /**
+   * @brief Render the FM operators of all lanes for one control block
+   */
+  void renderFmBlock(Float4 *out, int len) {
+    const Float4 invLen = 1.0f / static_cast<float>(len);
+    for (int k = 0; k < FM_OPERATORS; ++k) {
+      Float4 target = fmEnv_[k].advance(len) * fmScale_[k];
+      fm_.gainStep[k] = (target - fm_.gain[k]) * invLen;
+    }
+    fmKernel_(fm_, sineTable_, out, len);
+  }
+
+  /**
+   * @brief One sample of a mixing oscillator for all lanes
+   */
+  Float4 oscillator(Float4 phase, Float4 dt, Float4 invDt, const MixGains &g) {
+    Float4 out = 0.0f;
+    if (g.sine > 0.0f)
+      out += g.sine * sin2Pi(phase);
+    if (g.triangle > 0.0f) {
+      Float4 tri = select(cmplt(phase, 0.5f), phase * 4.0f - 1.0f,
+                          3.0f - phase * 4.0f);
+      out += g.triangle * tri;
+    }
+    if (g.sawtooth > 0.0f) {
+      Float4 saw = phase * 2.0f - 1.0f - polyBlep(phase, dt, invDt);
+      out += g.sawtooth * saw;
+    }
+    if (g.square > 0.0f) {
+      // Pulse width fixed at 0.5, the MixingOscillator default
+      Float4 edge = wrapPhase(phase + 0.5f);
+      Float4 sqr = select(cmplt(phase, 0.5f), Float4(1.0f), Float4(-1.0f)) +
+                   polyBlep(phase, dt, invDt) - polyBlep(edge, dt, invDt);
+      out += g.square * sqr;
+    }
+    if (g.noise > 0.0f)
+      out += g.noise * noise_.nextLanes();
+    return out;
+  }
+
+  /**
+   * @brief Render one control block of all four lanes into a mono buffer
+   */
+  void renderControlBlock(float *out, int len, Sample lfoVal, float gain) {
+    // ---- Control rate: envelopes and cutoff for all lanes ----
+    Float4 vel = Float4::load(velocity_);
+    Float4 ampStart = Float4::load(ampEnv_.level) * vel;
+    Float4 ampEnd = ampEnv_.advance(len) * vel;
+    Float4 filterEnv = filterEnv_.advance(len);
+
+    alignas(16) float envVals[MAX_VOICES];
+    double pitch[MAX_VOICES];
+    filterEnv.store(envVals);
+    // Same modulation as Voice: envelope and LFO add octaves
+    const double envScale = filterEnvDepth_ * 4.0;
+    for (int v = 0; v < MAX_VOICES; ++v)
+      pitch[v] = std::clamp(basePitch_ + envVals[v] * envScale + lfoVal,
+                            MIN_CUTOFF_PITCH, MAX_CUTOFF_PITCH);
+    filters_.rampCutoffPitch(pitch, len);
+
+    const Float4 invLen = 1.0f / static_cast<float>(len);
+    Float4 amp = ampStart;
+    const Float4 ampStep = (ampEnd - ampStart) * invLen;
+
+    // ---- Audio rate: everything below advances four voices at once ----
+    Float4 phase1 = Float4::load(phase1_), phase2 = Float4::load(phase2_);
+    const Float4 dt1 = Float4::load(inc1_), dt2 = Float4::load(inc2_);
+    const Float4 inv1 = Float4::load(invInc1_), inv2 = Float4::load(invInc2_);
+
+    Float4 multi[CONTROL_BLOCK_SIZE];
+    const bool withMulti =
+        multiMode_ == MultiEngine::Mode::VPM && multiLevel_ > 0.0f;
+    if (withMulti)
+      renderFmBlock(multi, len);
+
+    // Oscillators -> filter bank -> VCA in one loop. The lambdas ignore
+    // the group index: every voice is in the one lane group
+    static_assert(FilterBank<MAX_VOICES>::GROUPS == 1,
+                  "render loop assumes a single lane group");
+    alignas(16) float lanes[MAX_VOICES];
+    filters_.process(
+        len,
+        [&](int i, int) {
+          Float4 x =
+              oscillator(phase1, dt1, inv1, osc1Mix_) * (1.0f - oscMix_) +
+              oscillator(phase2, dt2, inv2, osc2Mix_) * oscMix_;
+          if (withMulti)
+            x += multi[i] * multiLevel_;
+          phase1 = wrapPhase(phase1 + dt1);
+          phase2 = wrapPhase(phase2 + dt2);
+          return x;
+        },
+        [&](int i, int, Float4 y) {
+          amp += ampStep;
+          (y * amp).store(lanes);
+          out[i] = (lanes[0] + lanes[1] + lanes[2] + lanes[3]) * gain;
+        });
+
+    phase1.store(phase1_);
+    phase2.store(phase2_);
+  }
+};
+
+} // namespace synth
@@ -3,33 +3,98 @@
  * @file synth_engine.hpp
  * @brief Polyphonic synth engine with voice management
  *
- * Manages 4-voice polyphony with voice allocation and stealing.
+ * Manages a preallocated voice pool (4 voices by default, up to
+ * MAX_POLYPHONY) with O(1) allocation and selectable stealing.
  * Now includes wave mixing, preset support, and full ADSR control.
+ * The voice mix runs through the master effects bus (chorus, delay,
+ * reverb), all bypassed by default.
  */
 
 #include "../core/lfo.hpp"
 #include "../core/presets.hpp"
 #include "../core/types.hpp"
 #include "../core/voice.hpp"
+#include "../effects/effects_bus.hpp"
+#include "command_queue.hpp"
+#include "voice_pool.hpp"
+#include <algorithm>
 #include <array>
+#include <atomic>
+#include <cstdint>
+#include <memory>
 
 namespace synth {
 
 /**
  * @class SynthEngine
- * @brief 4-voice polyphonic synthesizer engine with wave mixing and presets
+ * @brief Polyphonic synthesizer engine with wave mixing and presets
  */
 class SynthEngine {
 public:
-  static constexpr int MAX_VOICES = 4;
-
-  SynthEngine() {
+  /**
+   * @param numVoices Polyphony (1 to MAX_POLYPHONY)
+   */
+  explicit SynthEngine(int numVoices = NUM_VOICES) : voices_(numVoices) {
     // Load init preset
     loadPreset(0);
     lfo_.setRate(2.0);
     lfo_.setShape(LFO::Shape::TRIANGLE);
   }
 
+  /**
+   * @brief Configure the engine for the device sample rate
+   *
+   * Recomputes every rate-dependent coefficient. Call before audio starts
+   * (or whenever the device rate changes), never from the audio thread.
+   *
+   * @param sampleRate Sample rate in Hz
+   */
+  void prepare(double sampleRate) {
+    sampleRate_ = sampleRate;
+    for (auto &voice : voices_)
+      voice.prepare(sampleRate);
+    lfo_.prepare(sampleRate);
+    effects_.prepare(sampleRate);
+  }
+
+  double getSampleRate() const { return sampleRate_; }
+
+  /**
+   * @brief Resize the voice pool; all voices are silenced
+   *
+   * Allocates; call before audio starts (then prepare() again), never from
+   * the audio thread. The current preset is re-applied to the new voices.
+   *
+   * @param numVoices Polyphony (clamped to 1 to MAX_POLYPHONY)
+   */
+  void setPolyphony(int numVoices) {
+    voices_.resize(numVoices);
+    loadPreset(currentPreset_);
+    for (auto &voice : voices_) {
+      voice.setOversampling(oversampling_);
+      voice.setWavetables(wavetables_.get());
+      voice.prepare(sampleRate_);
+    }
+  }
+
+  int getPolyphony() const { return voices_.size(); }
+  int getActiveVoiceCount() const { return voices_.getActiveCount(); }
+
+  void setStealPolicy(StealPolicy policy) { stealPolicy_ = policy; }
+  StealPolicy getStealPolicy() const { return stealPolicy_; }
+
+  /**
+   * @brief Restart every noise source from one seed
+   *
+   * Renders are already repeatable run to run; this pins the noise to a
+   * given seed. setPolyphony() builds new voices, so call it afterwards.
+   */
+  void seedNoise(uint32_t seed) {
+    lfo_.seedNoise(seed);
+    for (int i = 0; i < voices_.size(); ++i)
+      voices_[i].seedNoise(seed + 3 * static_cast<uint32_t>(i + 1));
+  }
+
   // ==================== Note Control ====================
 
   /**
@@ -38,16 +103,7 @@ public:
    * @param velocity Note velocity (0.0 to 1.0)
    */
   void noteOn(int note, double velocity = 1.0) {
-    Voice *target = nullptr;
-    for (auto &voice : voices_) {
-      if (!voice.isActive()) {
-        target = &voice;
-        break;
-      }
-    }
-    if (!target)
-      target = &voices_[0]; // Simple steal
-    target->noteOn(note, velocity);
+    voices_[voices_.allocate(stealPolicy_)].noteOn(note, velocity);
   }
 
   /**
@@ -55,19 +111,22 @@ public:
    * @param note MIDI note number
    */
   void noteOff(int note) {
-    for (auto &voice : voices_) {
-      if (voice.isActive() && voice.getNote() == note) {
+    voices_.forEachHeld([this, note](int index, Voice &voice) {
+      if (voice.getNote() == note) {
         voice.noteOff();
+        voices_.release(index);
       }
-    }
+    });
   }
 
   /**
    * @brief Release all notes
    */
   void allNotesOff() {
-    for (auto &voice : voices_)
+    voices_.forEachHeld([this](int index, Voice &voice) {
       voice.noteOff();
+      voices_.release(index);
+    });
   }
 
   // ==================== Preset System ====================
@@ -90,6 +149,20 @@ public:
   void applyPreset(const SynthPreset &preset) {
     for (auto &v : voices_) {
       v.setWaveMix(preset.waveMix);
+      v.setOsc2Pitch(preset.osc2Pitch);
+      v.setOscSync(preset.oscSync);
+      v.setRingMod(preset.ringMod);
+      v.setCrossModDepth(preset.crossModDepth);
+      v.setUnisonVoices(preset.unisonVoices);
+      v.setUnisonDetune(preset.unisonDetune);
+      v.setUnisonSpread(preset.unisonSpread);
+      v.setMultiLevel(preset.multiLevel);
+      v.setMultiMode(preset.multiMode);
+      v.setMultiShape(preset.multiShape);
+      v.setWaveTable(preset.waveTable);
+      v.setFmPatch(preset.fmPatch);
+      v.setAdditivePatch(preset.additivePatch);
+      v.setFilterType(preset.filterType);
       v.setFilterCutoff(preset.filterCutoff);
       v.setFilterResonance(preset.filterResonance);
       v.setFilterDrive(preset.filterDrive);
@@ -159,6 +232,119 @@ public:
       v.setOsc2Waveform(wf);
   }
 
+  // ==================== VCO2 Modulation ====================
+
+  void setOsc2Pitch(double semitones) {
+    for (auto &v : voices_)
+      v.setOsc2Pitch(semitones);
+  }
+
+  /**
+   * @brief Hard sync VCO2 to VCO1 in every voice
+   */
+  void setOscSync(bool on) {
+    for (auto &v : voices_)
+      v.setOscSync(on);
+  }
+
+  void setRingMod(bool on) {
+    for (auto &v : voices_)
+      v.setRingMod(on);
+  }
+
+  void setCrossModDepth(Parameter depth) {
+    for (auto &v : voices_)
+      v.setCrossModDepth(depth);
+  }
+
+  // ==================== Unison ====================
+
+  /**
+   * @brief Saws per voice in the unison stack (1 = off, 2 VCOs play)
+   */
+  void setUnisonVoices(int count) {
+    for (auto &v : voices_)
+      v.setUnisonVoices(count);
+  }
+
+  void setUnisonDetune(Parameter amount) {
+    for (auto &v : voices_)
+      v.setUnisonDetune(amount);
+  }
+
+  void setUnisonSpread(Parameter amount) {
+    for (auto &v : voices_)
+      v.setUnisonSpread(amount);
+  }
+
+  // ==================== Multi Engine (FM) ====================
+
+  /**
+   * @brief Multi engine level in every voice's mixer (0 = off, no cost)
+   */
+  void setMultiLevel(Parameter level) {
+    for (auto &v : voices_)
+      v.setMultiLevel(level);
+  }
+
+  void setMultiMode(MultiEngine::Mode mode) {
+    for (auto &v : voices_)
+      v.setMultiMode(mode);
+  }
+
+  void setFmPatch(const FmPatch &patch) {
+    for (auto &v : voices_)
+      v.setFmPatch(patch);
+  }
+
+  void setAdditivePatch(const AdditivePatch &patch) {
+    for (auto &v : voices_)
+      v.setAdditivePatch(patch);
+  }
+
+  /**
+   * @brief WAVES shape: position across the frames of the current table
+   */
+  void setMultiShape(Parameter shape) {
+    for (auto &v : voices_)
+      v.setMultiShape(shape);
+  }
+
+  /**
+   * @brief User wavetables for WAVES mode (nullptr = built-in blend)
+   *
+   * Every voice reads the same set; open it with WavetableFile::open()
+   * so engines loading the same file also share one mapping. Not
+   * synchronized with rendering: call before audio starts, never from
+   * the audio thread.
+   */
+  void setWavetables(std::shared_ptr<const WavetableSet> set) {
+    wavetables_ = std::move(set);
+    for (auto &v : voices_)
+      v.setWavetables(wavetables_.get());
+  }
+
+  /**
+   * @brief Select the user table WAVES mode plays (0-based)
+   */
+  void setWaveTable(int index) {
+    for (auto &v : voices_)
+      v.setWaveTable(index);
+  }
+
+  /**
+   * @brief Select the FM algorithm (0..FM_NUM_ALGORITHMS-1)
+   */
+  void setFmAlgorithm(int algorithm) {
+    for (auto &v : voices_)
+      v.multi().fm().setAlgorithm(algorithm);
+  }
+
+  void setFmFeedback(Parameter amount) {
+    for (auto &v : voices_)
+      v.multi().fm().setFeedback(amount);
+  }
+
   // ==================== Filter Control ====================
 
   void setFilterCutoff(Frequency f) {
@@ -176,6 +362,28 @@ public:
       v.setFilterDrive(d);
   }
 
+  /**
+   * @brief Filter model for every voice (see Voice::setFilterType)
+   */
+  void setFilterType(FilterType type) {
+    for (auto &v : voices_)
+      v.setFilterType(type);
+  }
+
+  /**
+   * @brief Oversampling of the driven filter stage (1, 2 or 4)
+   *
+   * Only the saturating filter runs at the higher rate; oscillators,
+   * envelopes and effects stay at the device rate.
+   */
+  void setOversampling(int factor) {
+    oversampling_ = factor;
+    for (auto &v : voices_)
+      v.setOversampling(factor);
+  }
+
+  int getOversampling() const { return oversampling_; }
+
   // ==================== ADSR Control ====================
 
   /**
@@ -223,12 +431,175 @@ public:
 
   void setLfoRate(Frequency hz) { lfo_.setRate(hz); }
   void setLfoShape(LFO::Shape s) { lfo_.setShape(s); }
+  /** @brief LFO -> cutoff depth, in octaves at full LFO swing */
   void setLfoDepth(Parameter depth) { lfoDepth_ = depth; }
 
+  // ==================== Effects Control ====================
+
+  void setChorusEnabled(bool on) { effects_.setChorusEnabled(on); }
+  void setChorusRate(double hz) { effects_.chorus().setRate(hz); }
+  void setChorusDepth(Parameter d) { effects_.chorus().setDepth(d); }
+  void setChorusMix(Parameter m) { effects_.chorus().setMix(m); }
+
+  void setDelayEnabled(bool on) { effects_.setDelayEnabled(on); }
+  void setDelayTime(double ms) { effects_.delay().setDelayTime(ms); }
+  void setDelayFeedback(Parameter fb) { effects_.delay().setFeedback(fb); }
+  void setDelayMix(Parameter m) { effects_.delay().setMix(m); }
+
+  void setReverbEnabled(bool on) { effects_.setReverbEnabled(on); }
+  void setReverbDecay(Parameter d) { effects_.reverb().setDecay(d); }
+  void setReverbMix(Parameter m) { effects_.reverb().setMix(m); }
+
+  bool isChorusEnabled() const { return effects_.isChorusEnabled(); }
+  bool isDelayEnabled() const { return effects_.isDelayEnabled(); }
+  bool isReverbEnabled() const { return effects_.isReverbEnabled(); }
+
   // ==================== Master Control ====================
 
   void setMasterVolume(Parameter vol) { masterVolume_ = vol; }
 
+  // ==================== Thread-Safe Control ====================
+
+  /**
+   * @brief Queue a command for the audio thread (UI thread only)
+   *
+   * The direct setters above are not safe while the audio callback runs;
+   * a single control thread should post commands here instead. Commands
+   * must be posted in non-decreasing sampleTime order.
+   *
+   * @return false if the queue is full and the command was dropped
+   */
+  bool postCommand(const EngineCommand &cmd) { return commands_.push(cmd); }
+
+  /**
+   * @brief Frames rendered so far (safe to read from any thread)
+   */
+  uint64_t getSampleTime() const {
+    return sampleTime_.load(std::memory_order_acquire);
+  }
+
+  /**
+   * @brief Apply a command immediately (audio thread)
+   */
+  void applyCommand(const EngineCommand &cmd) {
+    using Type = EngineCommand::Type;
+    switch (cmd.type) {
+    case Type::NOTE_ON:
+      noteOn(cmd.note, cmd.value);
+      break;
+    case Type::NOTE_OFF:
+      noteOff(cmd.note);
+      break;
+    case Type::ALL_NOTES_OFF:
+      allNotesOff();
+      break;
+    case Type::LOAD_PRESET:
+      loadPreset(cmd.note);
+      break;
+    case Type::SET_WAVE_MIX:
+      setWaveMix(cmd.waveMix);
+      break;
+    case Type::SET_OSC2_PITCH:
+      setOsc2Pitch(cmd.value);
+      break;
+    case Type::SET_OSC_SYNC:
+      setOscSync(cmd.value > 0.5);
+      break;
+    case Type::SET_RING_MOD:
+      setRingMod(cmd.value > 0.5);
+      break;
+    case Type::SET_CROSS_MOD:
+      setCrossModDepth(cmd.value);
+      break;
+    case Type::SET_UNISON_VOICES:
+      setUnisonVoices(static_cast<int>(cmd.value));
+      break;
+    case Type::SET_UNISON_DETUNE:
+      setUnisonDetune(cmd.value);
+      break;
+    case Type::SET_UNISON_SPREAD:
+      setUnisonSpread(cmd.value);
+      break;
+    case Type::SET_MULTI_LEVEL:
+      setMultiLevel(cmd.value);
+      break;
+    case Type::SET_MULTI_MODE:
+      setMultiMode(static_cast<MultiEngine::Mode>(
+          std::clamp(static_cast<int>(cmd.value), 0, 3)));
+      break;
+    case Type::SET_MULTI_SHAPE:
+      setMultiShape(cmd.value);
+      break;
+    case Type::SET_WAVE_TABLE:
+      setWaveTable(static_cast<int>(cmd.value));
+      break;
+    case Type::SET_FM_ALGORITHM:
+      setFmAlgorithm(static_cast<int>(cmd.value) - 1);
+      break;
+    case Type::SET_FILTER_CUTOFF:
+      setFilterCutoff(cmd.value);
+      break;
+    case Type::SET_FILTER_RESONANCE:
+      setFilterResonance(cmd.value);
+      break;
+    case Type::SET_FILTER_DRIVE:
+      setFilterDrive(cmd.value);
+      break;
+    case Type::SET_FILTER_TYPE:
+      setFilterType(static_cast<FilterType>(
+          std::clamp(static_cast<int>(cmd.value), 0, 2)));
+      break;
+    case Type::SET_AMP_ATTACK:
+      setAmpAttack(cmd.value);
+      break;
+    case Type::SET_AMP_DECAY:
+      setAmpDecay(cmd.value);
+      break;
+    case Type::SET_AMP_SUSTAIN:
+      setAmpSustain(cmd.value);
+      break;
+    case Type::SET_AMP_RELEASE:
+      setAmpRelease(cmd.value);
+      break;
+    case Type::SET_MASTER_VOLUME:
+      setMasterVolume(cmd.value);
+      break;
+    case Type::SET_CHORUS_ENABLED:
+      setChorusEnabled(cmd.value > 0.5);
+      break;
+    case Type::SET_CHORUS_RATE:
+      setChorusRate(cmd.value);
+      break;
+    case Type::SET_CHORUS_DEPTH:
+      setChorusDepth(cmd.value);
+      break;
+    case Type::SET_CHORUS_MIX:
+      setChorusMix(cmd.value);
+      break;
+    case Type::SET_DELAY_ENABLED:
+      setDelayEnabled(cmd.value > 0.5);
+      break;
+    case Type::SET_DELAY_TIME:
+      setDelayTime(cmd.value);
+      break;
+    case Type::SET_DELAY_FEEDBACK:
+      setDelayFeedback(cmd.value);
+      break;
+    case Type::SET_DELAY_MIX:
+      setDelayMix(cmd.value);
+      break;
+    case Type::SET_REVERB_ENABLED:
+      setReverbEnabled(cmd.value > 0.5);
+      break;
+    case Type::SET_REVERB_DECAY:
+      setReverbDecay(cmd.value);
+      break;
+    case Type::SET_REVERB_MIX:
+      setReverbMix(cmd.value);
+      break;
+    }
+  }
+
   // ==================== Audio Processing ====================
 
   /**
@@ -236,20 +607,17 @@ public:
    * @return Mixed audio sample
    */
   Sample process() {
-    Sample lfoVal = lfo_.process();
+    const Sample lfoVal = lfo_.process() * lfoDepth_;
     Sample output = 0.0;
 
-    for (auto &voice : voices_) {
-      if (voice.isActive()) {
-        output += voice.process(lfoVal * lfoDepth_);
-      }
-    }
+    voices_.forEachActive(
+        [&output, lfoVal](Voice &voice) { output += voice.process(lfoVal); });
 
     return output * masterVolume_ * 0.5;
   }
 
   /**
-   * @brief Process one stereo sample
+   * @brief Process one stereo sample through the effects bus
    * @param left Left channel output
    * @param right Right channel output
    */
@@ -257,14 +625,107 @@ public:
     Sample mono = process();
     left = mono;
     right = mono;
+    effects_.processFrame(left, right);
+  }
+
+  /**
+   * @brief Render a block of stereo samples
+   *
+   * Queued commands are applied first, each at its sample offset within
+   * the block. Rendering runs voice by voice into scratch buffers rather
+   * than walking every voice once per sample.
+   *
+   * @param left Left channel output (frames long)
+   * @param right Right channel output (frames long)
+   * @param frames Number of frames to render
+   */
+  void processBlock(float *left, float *right, uint32_t frames) {
+    uint64_t now = sampleTime_.load(std::memory_order_relaxed);
+    const uint64_t end = now + frames;
+
+    while (now < end) {
+      // Apply everything that is due, then render up to the next command
+      const EngineCommand *cmd = commands_.front();
+      while (cmd && cmd->sampleTime <= now) {
+        applyCommand(*cmd);
+        commands_.pop();
+        cmd = commands_.front();
+      }
+
+      uint64_t until = (cmd && cmd->sampleTime < end) ? cmd->sampleTime : end;
+      uint32_t n = static_cast<uint32_t>(until - now);
+      render(left, right, n);
+      left += n;
+      right += n;
+      now = until;
+    }
+
+    sampleTime_.store(end, std::memory_order_release);
   }
 
 private:
-  std::array<Voice, MAX_VOICES> voices_;
+  VoicePool voices_;
+  StealPolicy stealPolicy_ = StealPolicy::RELEASED_FIRST;
   LFO lfo_;
+  std::array<Sample, MAX_BLOCK_SIZE / CONTROL_BLOCK_SIZE + 1> lfoBuffer_;
+  std::array<Sample, MAX_BLOCK_SIZE> mixBuffer_;
+  std::array<Sample, MAX_BLOCK_SIZE> rightBuffer_;
+  EffectsBus effects_;
+  VoiceScratch scratch_;
+  double sampleRate_ = DEFAULT_SAMPLE_RATE;
   Parameter lfoDepth_ = 0.2;
   Parameter masterVolume_ = 0.8;
   int currentPreset_ = 0;
+  int oversampling_ = OVERSAMPLING;
+  std::shared_ptr<const WavetableSet> wavetables_;
+
+  CommandQueue commands_;
+  std::atomic<uint64_t> sampleTime_{0};
+
+  /**
+   * @brief Render frames with no command changes, in MAX_BLOCK_SIZE chunks
+   *
+   * Modulation inside each chunk runs at control rate.
+   */
+  void render(float *left, float *right, uint32_t frames) {
+    while (frames > 0) {
+      int n = static_cast<int>(
+          std::min<uint32_t>(frames, static_cast<uint32_t>(MAX_BLOCK_SIZE)));
+
+      // LFO runs at control rate: one value per CONTROL_BLOCK_SIZE samples
+      for (int offset = 0, k = 0; offset < n;
+           offset += CONTROL_BLOCK_SIZE, ++k) {
+        int len = std::min(CONTROL_BLOCK_SIZE, n - offset);
+        lfoBuffer_[k] = lfo_.advance(len) * lfoDepth_;
+      }
+
+      std::fill(mixBuffer_.begin(), mixBuffer_.begin() + n, 0.0);
+      std::fill(rightBuffer_.begin(), rightBuffer_.begin() + n, 0.0);
+      const bool silent = voices_.getActiveCount() == 0;
+      voices_.forEachActive([this, n](Voice &voice) {
+        voice.processBlock(mixBuffer_.data(), rightBuffer_.data(),
+                           lfoBuffer_.data(), n, scratch_);
+      });
+
+      const Sample gain = masterVolume_ * 0.5;
+      for (int i = 0; i < n; ++i) {
+        mixBuffer_[i] *= gain;
+        rightBuffer_[i] *= gain;
+      }
+
+      effects_.processBlock(mixBuffer_.data(), rightBuffer_.data(), n,
+                            silent);
+
+      for (int i = 0; i < n; ++i) {
+        left[i] = static_cast<float>(mixBuffer_[i]);
+        right[i] = static_cast<float>(rightBuffer_[i]);
+      }
+
+      left += n;
+      right += n;
+      frames -= static_cast<uint32_t>(n);
+    }
+  }
 };
 
 } // namespace synth
@@ -0,0 +1,231 @@
+#pragma once
+/**
+ * @file voice_pool.hpp
+ * @brief Preallocated voice pool with O(1) allocation and stealing
+ *
+ * Voices live in one contiguous vector sized before audio starts. Every
+ * voice is on either the FREE or the ACTIVE list (ACTIVE is in note-on
+ * order); active voices past note-off are also on the RELEASED list, in
+ * note-off order. All lists are intrusive index links, so allocation,
+ * release and stealing never search or allocate.
+ *
+ * Rendering walks only the ACTIVE list, so idle voices cost nothing.
+ */
+
+#include "../core/types.hpp"
+#include "../core/voice.hpp"
+#include <algorithm>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace synth {
+
+/**
+ * @brief Which voice to take when every voice is busy
+ */
+enum class StealPolicy {
+  OLDEST,        // Earliest note-on
+  QUIETEST,      // Lowest amp level past the attack, else oldest
+  RELEASED_FIRST // Oldest released voice, else oldest held voice
+};
+
+/**
+ * @brief Parse "oldest", "quietest" or "released"
+ * @return false if the name is unknown
+ */
+inline bool stealPolicyFromName(const std::string &name, StealPolicy &policy) {
+  if (name == "oldest") {
+    policy = StealPolicy::OLDEST;
+  } else if (name == "quietest") {
+    policy = StealPolicy::QUIETEST;
+  } else if (name == "released") {
+    policy = StealPolicy::RELEASED_FIRST;
+  } else {
+    return false;
+  }
+  return true;
+}
+
+/**
+ * @class VoicePool
+ * @brief Fixed set of voices plus free/active/released lists
+ */
+class VoicePool {
+public:
+  explicit VoicePool(int numVoices = NUM_VOICES) { resize(numVoices); }
+
+  /**
+   * @brief Reallocate the pool; every voice becomes free
+   *
+   * Allocates; call before audio starts, never from the audio thread.
+   *
+   * @param numVoices Voice count, clamped to 1..MAX_POLYPHONY
+   */
+  void resize(int numVoices) {
+    numVoices = std::clamp(numVoices, 1, MAX_POLYPHONY);
+    // Construct each voice in place so every one seeds its own noise
+    voices_ = std::vector<Voice>(static_cast<size_t>(numVoices));
+    orderLinks_.assign(static_cast<size_t>(numVoices), Link());
+    releaseLinks_.assign(static_cast<size_t>(numVoices), Link());
+    released_.assign(static_cast<size_t>(numVoices), false);
+    free_ = active_ = releasedList_ = List();
+    for (int i = 0; i < numVoices; ++i)
+      pushBack(orderLinks_, free_, i);
+    quietest_ = -1;
+  }
+
+  int size() const { return static_cast<int>(voices_.size()); }
+  int getActiveCount() const { return active_.count; }
+
+  Voice &operator[](int index) { return voices_[static_cast<size_t>(index)]; }
+
+  // Iterate every voice, active or not (parameter changes)
+  std::vector<Voice>::iterator begin() { return voices_.begin(); }
+  std::vector<Voice>::iterator end() { return voices_.end(); }
+
+  /**
+   * @brief Take a free voice, or steal one per policy
+   *
+   * The returned voice becomes the newest active voice; the caller
+   * triggers it with Voice::noteOn().
+   *
+   * @return Voice index
+   */
+  int allocate(StealPolicy policy) {
+    int index = free_.head;
+    if (index >= 0) {
+      unlink(orderLinks_, free_, index);
+    } else {
+      index = pickVictim(policy);
+      unlink(orderLinks_, active_, index);
+      clearReleased(index);
+    }
+    pushBack(orderLinks_, active_, index);
+    return index;
+  }
+
+  /**
+   * @brief Mark an active voice as released (after Voice::noteOff())
+   */
+  void release(int index) {
+    if (released_[static_cast<size_t>(index)])
+      return;
+    released_[static_cast<size_t>(index)] = true;
+    pushBack(releaseLinks_, releasedList_, index);
+  }
+
+  /**
+   * @brief Call fn(index, voice) for every held (not released) voice,
+   *        oldest first. fn may call release() on the voice it is given.
+   */
+  template <typename Fn> void forEachHeld(Fn fn) {
+    for (int i = active_.head; i >= 0;) {
+      int next = orderLinks_[static_cast<size_t>(i)].next;
+      if (!released_[static_cast<size_t>(i)])
+        fn(i, voices_[static_cast<size_t>(i)]);
+      i = next;
+    }
+  }
+
+  /**
+   * @brief Call fn(voice) for every sounding voice, then free the ones
+   *        that fell silent and cache the quietest survivor
+   *
+   * Voices still in their attack are never the quietest: a slow attack
+   * starts near silence, and stealing it would cut the note just played.
+   */
+  template <typename Fn> void forEachActive(Fn fn) {
+    quietest_ = -1;
+    Sample quietestLevel = 0.0;
+    for (int i = active_.head; i >= 0;) {
+      int next = orderLinks_[static_cast<size_t>(i)].next;
+      Voice &voice = voices_[static_cast<size_t>(i)];
+      fn(voice);
+      if (!voice.isActive()) {
+        unlink(orderLinks_, active_, i);
+        clearReleased(i);
+        pushBack(orderLinks_, free_, i);
+      } else if (!voice.isAttacking() &&
+                 (quietest_ < 0 || voice.getLevel() < quietestLevel)) {
+        quietest_ = i;
+        quietestLevel = voice.getLevel();
+      }
+      i = next;
+    }
+  }
+
+private:
+  struct Link {
+    int prev = -1;
+    int next = -1;
+  };
+
+  struct List {
+    int head = -1;
+    int tail = -1;
+    int count = 0;
+  };
+
+  std::vector<Voice> voices_;
+  std::vector<Link> orderLinks_;   // FREE or ACTIVE (note-on order)
+  std::vector<Link> releaseLinks_; // RELEASED (note-off order)
+  std::vector<bool> released_;
+  List free_, active_, releasedList_;
+  int quietest_ = -1; // Cached by forEachActive(); -1 when unknown
+
+  int pickVictim(StealPolicy policy) {
+    switch (policy) {
+    case StealPolicy::QUIETEST:
+      if (quietest_ >= 0) {
+        int victim = quietest_;
+        quietest_ = -1; // Only valid until the next render pass
+        return victim;
+      }
+      // Every voice in its attack, or already stolen since the last
+      // render: fall back to released-first (with no released voice, the
+      // oldest)
+      return releasedList_.head >= 0 ? releasedList_.head : active_.head;
+    case StealPolicy::RELEASED_FIRST:
+      return releasedList_.head >= 0 ? releasedList_.head : active_.head;
+    case StealPolicy::OLDEST:
+    default:
+      return active_.head;
+    }
+  }
+
+  void clearReleased(int index) {
+    if (!released_[static_cast<size_t>(index)])
+      return;
+    released_[static_cast<size_t>(index)] = false;
+    unlink(releaseLinks_, releasedList_, index);
+  }
+
+  static void pushBack(std::vector<Link> &links, List &list, int index) {
+    Link &link = links[static_cast<size_t>(index)];
+    link.prev = list.tail;
+    link.next = -1;
+    if (list.tail >= 0)
+      links[static_cast<size_t>(list.tail)].next = index;
+    else
+      list.head = index;
+    list.tail = index;
+    ++list.count;
+  }
+
+  static void unlink(std::vector<Link> &links, List &list, int index) {
+    Link &link = links[static_cast<size_t>(index)];
+    if (link.prev >= 0)
+      links[static_cast<size_t>(link.prev)].next = link.next;
+    else
+      list.head = link.next;
+    if (link.next >= 0)
+      links[static_cast<size_t>(link.next)].prev = link.prev;
+    else
+      list.tail = link.prev;
+    link.prev = link.next = -1;
+    --list.count;
+  }
+};
+
+} // namespace synth
@@ -0,0 +1,226 @@
+#pragma once
+/**
+ * @file event_script.hpp
+ * @brief Plain-text note/parameter script for offline rendering
+ *
+ * One event per line: a time in seconds, a command and its arguments.
+ * Blank lines and text after '#' are ignored.
+ *
+ *   0.00  preset 2
+ *   0.00  on 60 0.8       # note, optional velocity
+ *   0.50  off 60
+ *   0.50  cutoff 1200     # cutoff resonance drive attack decay sustain
+ *                         # release volume take one value
+ *   0.50  osc2_pitch 12   # VCO2 offset in semitones
+ *   0.50  sync 1          # sync/ring: 1 = on, 0 = off; cross_mod 0..1
+ *   0.50  unison 8        # saws per voice, 1 = off (max 16);
+ *                         # unison_detune unison_spread take 0..1
+ *   0.50  multi 0.8       # multi engine (FM) level in the mixer
+ *   0.50  multi_mode 1    # 0 = VPM (FM), 1 = WAVES, 2 = noise,
+ *                         # 3 = additive
+ *   0.50  wave_table 3    # user table for WAVES; shape 0..1 scans it
+ *   0.50  fm_algorithm 5  # FM algorithm 1-8
+ *   0.50  filter_type 1   # 0 = SVF, 1 = ladder (24 dB/oct), 2 = ZDF
+ *   0.50  delay 1         # chorus/delay/reverb: 1 = on, 0 = bypass
+ *   0.50  delay_time 375  # chorus_rate chorus_depth chorus_mix
+ *                         # delay_time delay_feedback delay_mix
+ *                         # reverb_decay reverb_mix
+ *   1.00  mix 0 0 1 0.5 0 # sine tri saw square [noise]
+ *   1.00  alloff
+ *   3.00  end             # optional explicit length
+ */
+
+#include "../engine/command_queue.hpp"
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace synth {
+
+/**
+ * @class EventScript
+ * @brief Parsed, time-ordered list of engine commands
+ */
+class EventScript {
+public:
+  struct Event {
+    double time; // Seconds
+    EngineCommand command;
+  };
+
+  /**
+   * @brief Load and parse a script file
+   * @param path Script file path
+   * @param error Receives a message (with line number) on failure
+   * @return true on success
+   */
+  bool load(const std::string &path, std::string &error) {
+    std::ifstream in(path);
+    if (!in) {
+      error = "cannot open " + path;
+      return false;
+    }
+    return parse(in, error);
+  }
+
+  /**
+   * @brief Parse a script from a stream
+   * @param in Input stream
+   * @param error Receives a message (with line number) on failure
+   * @return true on success
+   */
+  bool parse(std::istream &in, std::string &error) {
+    events_.clear();
+    endTime_ = -1.0;
+
+    std::string line;
+    int lineNo = 0;
+    while (std::getline(in, line)) {
+      ++lineNo;
+      line = line.substr(0, line.find('#'));
+      std::istringstream ls(line);
+
+      double time;
+      std::string cmd;
+      if (!(ls >> time))
+        continue; // Blank or comment-only line
+      if (!(ls >> cmd) || time < 0.0) {
+        error = "line " + std::to_string(lineNo) + ": expected <time> <cmd>";
+        return false;
+      }
+
+      if (!parseCommand(time, cmd, ls)) {
+        error = "line " + std::to_string(lineNo) + ": bad '" + cmd + "'";
+        return false;
+      }
+    }
+
+    std::stable_sort(events_.begin(), events_.end(),
+                     [](const Event &a, const Event &b) {
+                       return a.time < b.time;
+                     });
+    return true;
+  }
+
+  const std::vector<Event> &getEvents() const { return events_; }
+
+  /**
+   * @brief Script length: the 'end' time, or the last event plus a tail
+   * @param tail Seconds to keep rendering after the last event
+   */
+  double getDuration(double tail) const {
+    if (endTime_ >= 0.0)
+      return endTime_;
+    double last = events_.empty() ? 0.0 : events_.back().time;
+    return last + tail;
+  }
+
+  /**
+   * @brief Stamp every event with its frame time at the given rate
+   */
+  std::vector<EngineCommand> toCommands(double sampleRate) const {
+    std::vector<EngineCommand> commands;
+    commands.reserve(events_.size());
+    for (const Event &e : events_) {
+      EngineCommand c = e.command;
+      c.sampleTime = static_cast<uint64_t>(std::llround(e.time * sampleRate));
+      commands.push_back(c);
+    }
+    return commands;
+  }
+
+private:
+  std::vector<Event> events_;
+  double endTime_ = -1.0;
+
+  bool parseCommand(double time, const std::string &cmd, std::istream &args) {
+    using Type = EngineCommand::Type;
+
+    if (cmd == "on") {
+      int note;
+      double velocity;
+      if (!(args >> note))
+        return false;
+      if (!(args >> velocity))
+        velocity = 1.0;
+      add(time, EngineCommand::noteOn(note, velocity));
+    } else if (cmd == "off") {
+      int note;
+      if (!(args >> note))
+        return false;
+      add(time, EngineCommand::noteOff(note));
+    } else if (cmd == "alloff") {
+      add(time, EngineCommand::allNotesOff());
+    } else if (cmd == "preset") {
+      int index;
+      if (!(args >> index))
+        return false;
+      add(time, EngineCommand::loadPreset(index));
+    } else if (cmd == "mix") {
+      WaveMix mix;
+      if (!(args >> mix.sine >> mix.triangle >> mix.sawtooth >> mix.square))
+        return false;
+      if (!(args >> mix.noise))
+        mix.noise = 0.0;
+      add(time, EngineCommand::setWaveMix(mix));
+    } else if (cmd == "end") {
+      endTime_ = time;
+    } else {
+      static const struct {
+        const char *name;
+        Type type;
+      } params[] = {{"cutoff", Type::SET_FILTER_CUTOFF},
+                    {"resonance", Type::SET_FILTER_RESONANCE},
+                    {"drive", Type::SET_FILTER_DRIVE},
+                    {"filter_type", Type::SET_FILTER_TYPE},
+                    {"attack", Type::SET_AMP_ATTACK},
+                    {"decay", Type::SET_AMP_DECAY},
+                    {"sustain", Type::SET_AMP_SUSTAIN},
+                    {"release", Type::SET_AMP_RELEASE},
+                    {"volume", Type::SET_MASTER_VOLUME},
+                    {"osc2_pitch", Type::SET_OSC2_PITCH},
+                    {"sync", Type::SET_OSC_SYNC},
+                    {"ring", Type::SET_RING_MOD},
+                    {"cross_mod", Type::SET_CROSS_MOD},
+                    {"unison", Type::SET_UNISON_VOICES},
+                    {"unison_detune", Type::SET_UNISON_DETUNE},
+                    {"unison_spread", Type::SET_UNISON_SPREAD},
+                    {"multi", Type::SET_MULTI_LEVEL},
+                    {"multi_mode", Type::SET_MULTI_MODE},
+                    {"shape", Type::SET_MULTI_SHAPE},
+                    {"wave_table", Type::SET_WAVE_TABLE},
+                    {"fm_algorithm", Type::SET_FM_ALGORITHM},
+                    {"chorus", Type::SET_CHORUS_ENABLED},
+                    {"chorus_rate", Type::SET_CHORUS_RATE},
+                    {"chorus_depth", Type::SET_CHORUS_DEPTH},
+                    {"chorus_mix", Type::SET_CHORUS_MIX},
+                    {"delay", Type::SET_DELAY_ENABLED},
+                    {"delay_time", Type::SET_DELAY_TIME},
+                    {"delay_feedback", Type::SET_DELAY_FEEDBACK},
+                    {"delay_mix", Type::SET_DELAY_MIX},
+                    {"reverb", Type::SET_REVERB_ENABLED},
+                    {"reverb_decay", Type::SET_REVERB_DECAY},
+                    {"reverb_mix", Type::SET_REVERB_MIX}};
+      for (const auto &p : params) {
+        if (cmd == p.name) {
+          double value;
+          if (!(args >> value))
+            return false;
+          add(time, EngineCommand::setParameter(p.type, value));
+          return true;
+        }
+      }
+      return false;
+    }
+    return true;
+  }
+
+  void add(double time, const EngineCommand &command) {
+    events_.push_back({time, command});
+  }
+};
+
+} // namespace synth
@@ -0,0 +1,128 @@
+#pragma once
+/**
+ * @file wav_writer.hpp
+ * @brief Streaming 24-bit PCM stereo WAV writer
+ *
+ * Writes samples as they are rendered and patches the RIFF sizes on
+ * close(), so arbitrarily long renders never sit in memory.
+ */
+
+#include "../core/types.hpp"
+#include <algorithm>
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <vector>
+
+namespace synth {
+
+/**
+ * @class WavWriter
+ * @brief Writes interleaved stereo float samples as 24-bit PCM
+ */
+class WavWriter {
+public:
+  WavWriter() : sampleRate_(0), framesWritten_(0) {}
+  ~WavWriter() { close(); }
+
+  /**
+   * @brief Create the file and write a placeholder header
+   * @param path Output file path
+   * @param sampleRate Sample rate in Hz
+   * @return true on success
+   */
+  bool open(const std::string &path, uint32_t sampleRate) {
+    file_.open(path, std::ios::binary | std::ios::trunc);
+    if (!file_)
+      return false;
+    sampleRate_ = sampleRate;
+    framesWritten_ = 0;
+    writeHeader();
+    return static_cast<bool>(file_);
+  }
+
+  /**
+   * @brief Append a block of stereo frames
+   * @param left Left channel (frames long)
+   * @param right Right channel (frames long)
+   * @param frames Number of frames
+   * @return true if the write succeeded
+   */
+  bool write(const float *left, const float *right, uint32_t frames) {
+    buffer_.resize(static_cast<size_t>(frames) * 2 * BYTES_PER_SAMPLE);
+    uint8_t *p = buffer_.data();
+    for (uint32_t i = 0; i < frames; ++i) {
+      p = packSample(p, left[i]);
+      p = packSample(p, right[i]);
+    }
+    file_.write(reinterpret_cast<const char *>(buffer_.data()),
+                static_cast<std::streamsize>(buffer_.size()));
+    framesWritten_ += frames;
+    return static_cast<bool>(file_);
+  }
+
+  /**
+   * @brief Finalize header sizes and close the file
+   */
+  void close() {
+    if (!file_.is_open())
+      return;
+    file_.seekp(0);
+    writeHeader();
+    file_.close();
+  }
+
+  uint64_t getFramesWritten() const { return framesWritten_; }
+
+private:
+  static constexpr int BYTES_PER_SAMPLE = 3; // 24-bit
+  static constexpr int CHANNELS = 2;
+
+  std::ofstream file_;
+  std::vector<uint8_t> buffer_;
+  uint32_t sampleRate_;
+  uint64_t framesWritten_;
+
+  static uint8_t *packSample(uint8_t *p, float x) {
+    double clamped = std::clamp(static_cast<double>(x), -1.0, 1.0);
+    int32_t v = static_cast<int32_t>(clamped * 8388607.0);
+    p[0] = static_cast<uint8_t>(v & 0xFF);
+    p[1] = static_cast<uint8_t>((v >> 8) & 0xFF);
+    p[2] = static_cast<uint8_t>((v >> 16) & 0xFF);
+    return p + 3;
+  }
+
+  void put16(uint16_t v) {
+    char b[2] = {static_cast<char>(v & 0xFF), static_cast<char>(v >> 8)};
+    file_.write(b, 2);
+  }
+
+  void put32(uint32_t v) {
+    put16(static_cast<uint16_t>(v & 0xFFFF));
+    put16(static_cast<uint16_t>(v >> 16));
+  }
+
+  void writeHeader() {
+    const uint32_t blockAlign = CHANNELS * BYTES_PER_SAMPLE;
+    const uint32_t dataBytes =
+        static_cast<uint32_t>(framesWritten_ * blockAlign);
+
+    file_.write("RIFF", 4);
+    put32(36 + dataBytes);
+    file_.write("WAVE", 4);
+
+    file_.write("fmt ", 4);
+    put32(16);
+    put16(1); // PCM
+    put16(CHANNELS);
+    put32(sampleRate_);
+    put32(sampleRate_ * blockAlign);
+    put16(static_cast<uint16_t>(blockAlign));
+    put16(BYTES_PER_SAMPLE * 8);
+
+    file_.write("data", 4);
+    put32(dataBytes);
+  }
+};
+
+} // namespace synth
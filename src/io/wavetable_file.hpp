@@ -0,0 +1,293 @@
+#pragma once
+/**
+ * @file wavetable_file.hpp
+ * @brief Memory-mapped user wavetable banks (.mxwt) and their writer
+ *
+ * A bank file holds tables x frames single cycles, already band-limited
+ * into the same per-octave mipmap levels and guard-sample layout as the
+ * built-in WavetableBank. Loading only maps the file read-only: nothing
+ * is copied or computed, the OS pages in the frames that are played, and
+ * every voice and engine reading the bank shares those pages.
+ *
+ * Layout (little-endian):
+ *   0   char[4]  "MXWT"
+ *   4   u32      version (1)
+ *   8   u32      byte-order mark 0x01020304
+ *   12  u32      tables
+ *   16  u32      frames per table
+ *   20  u32      cycle size (WAVETABLE_SIZE)
+ *   24  u32      mipmap levels (WAVETABLE_LEVELS)
+ *   28  u32      floats per stored cycle (WAVETABLE_STRIDE)
+ *   32  u32      byte offset of the sample data (64)
+ *   64  float32  [table][frame][level][WAVETABLE_STRIDE]
+ */
+
+#include "../core/types.hpp"
+#include "../core/wavetable.hpp"
+#include "../platform/mapped_file.hpp"
+#include <algorithm>
+#include <complex>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <limits>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace synth {
+
+constexpr uint32_t WAVETABLE_FILE_VERSION = 1;
+constexpr uint32_t WAVETABLE_FILE_BYTE_ORDER = 0x01020304;
+constexpr uint32_t WAVETABLE_FILE_DATA_OFFSET = 64;
+
+/**
+ * @struct WavetableFileHeader
+ * @brief Fixed header at the start of a bank file
+ */
+struct WavetableFileHeader {
+  char magic[4] = {'M', 'X', 'W', 'T'};
+  uint32_t version = WAVETABLE_FILE_VERSION;
+  uint32_t byteOrder = WAVETABLE_FILE_BYTE_ORDER;
+  uint32_t tables = 0;
+  uint32_t frames = 0;
+  uint32_t cycleSize = WAVETABLE_SIZE;
+  uint32_t levels = WAVETABLE_LEVELS;
+  uint32_t stride = WAVETABLE_STRIDE;
+  uint32_t dataOffset = WAVETABLE_FILE_DATA_OFFSET;
+};
+
+static_assert(sizeof(WavetableFileHeader) <= WAVETABLE_FILE_DATA_OFFSET,
+              "header must fit before the sample data");
+
+/**
+ * @class WavetableFile
+ * @brief Opens bank files as shared, read-only WavetableSets
+ */
+class WavetableFile {
+public:
+  /**
+   * @brief Map a bank file, or share the mapping if it is already open
+   *
+   * The returned pointer keeps the mapping alive; the file is unmapped
+   * when the last engine drops it. Allocates and does file I/O, so call
+   * it from the UI or loader thread, never the audio thread.
+   *
+   * @param path Bank file path
+   * @param error Set to a message on failure
+   * @return The tables, or nullptr on failure
+   */
+  static std::shared_ptr<const WavetableSet> open(const std::string &path,
+                                                  std::string &error) {
+    static std::mutex mutex;
+    static std::map<std::string, std::weak_ptr<const WavetableSet>> cache;
+
+    std::lock_guard<std::mutex> lock(mutex);
+    if (auto shared = cache[path].lock())
+      return shared;
+
+    auto mapping = std::make_shared<Mapping>();
+    if (!mapping->file.open(path)) {
+      error = "cannot map " + path;
+      return nullptr;
+    }
+    if (!validate(mapping->file, mapping->set, error))
+      return nullptr;
+
+    // Aliasing constructor: the set's lifetime is the mapping's
+    std::shared_ptr<const WavetableSet> shared(mapping, &mapping->set);
+    cache[path] = shared;
+    return shared;
+  }
+
+private:
+  struct Mapping {
+    MappedFile file;
+    WavetableSet set;
+  };
+
+  static bool validate(const MappedFile &file, WavetableSet &set,
+                       std::string &error) {
+    WavetableFileHeader header;
+    if (file.size() < WAVETABLE_FILE_DATA_OFFSET) {
+      error = "file too short for a wavetable header";
+      return false;
+    }
+    std::memcpy(&header, file.data(), sizeof(header));
+    if (std::memcmp(header.magic, "MXWT", 4) != 0) {
+      error = "not a wavetable bank (bad magic)";
+      return false;
+    }
+    if (header.version != WAVETABLE_FILE_VERSION ||
+        header.byteOrder != WAVETABLE_FILE_BYTE_ORDER) {
+      error = "unsupported wavetable bank version or byte order";
+      return false;
+    }
+    if (header.cycleSize != WAVETABLE_SIZE ||
+        header.levels != WAVETABLE_LEVELS ||
+        header.stride != WAVETABLE_STRIDE) {
+      error = "wavetable bank built for a different table size";
+      return false;
+    }
+    constexpr uint32_t maxCount = std::numeric_limits<int>::max();
+    if (header.tables == 0 || header.frames == 0 ||
+        header.tables > maxCount || header.frames > maxCount ||
+        header.dataOffset < sizeof(WavetableFileHeader) ||
+        header.dataOffset % alignof(float) != 0) {
+      error = "empty, oversized or misaligned wavetable bank";
+      return false;
+    }
+    // The counts are untrusted: divide the available bytes down rather
+    // than multiply the counts up, which could wrap
+    constexpr uint64_t frameBytes =
+        uint64_t{WAVETABLE_LEVELS} * WAVETABLE_STRIDE * sizeof(float);
+    if (file.size() < header.dataOffset ||
+        (file.size() - header.dataOffset) / frameBytes / header.frames <
+            header.tables) {
+      error = "wavetable bank is truncated";
+      return false;
+    }
+    set.data = reinterpret_cast<const float *>(
+        static_cast<const char *>(file.data()) + header.dataOffset);
+    set.tables = static_cast<int>(header.tables);
+    set.frames = static_cast<int>(header.frames);
+    return true;
+  }
+};
+
+/**
+ * @class WavetableWriter
+ * @brief Builds a bank from raw single cycles and writes it to disk
+ *
+ * Each frame is band-limited once per mipmap level with an FFT, keeping
+ * the same harmonic counts as the built-in tables. The frames are stored
+ * as given, with no normalization.
+ */
+class WavetableWriter {
+public:
+  /**
+   * @param framesPerTable Frames in every table of this bank
+   */
+  explicit WavetableWriter(int framesPerTable)
+      : frames_(std::max(framesPerTable, 1)) {}
+
+  /**
+   * @brief Append a table
+   * @param cycles framesPerTable cycles of WAVETABLE_SIZE samples each
+   * @return false if the frame count or a cycle length is wrong
+   */
+  bool addTable(const std::vector<std::vector<double>> &cycles) {
+    if (static_cast<int>(cycles.size()) != frames_)
+      return false;
+    for (const auto &cycle : cycles)
+      if (cycle.size() != static_cast<size_t>(WAVETABLE_SIZE))
+        return false;
+
+    std::vector<std::complex<double>> spectrum(WAVETABLE_SIZE);
+    std::vector<std::complex<double>> band(WAVETABLE_SIZE);
+    std::vector<double> level(WAVETABLE_SIZE);
+    for (const auto &cycle : cycles) {
+      std::copy(cycle.begin(), cycle.end(), spectrum.begin());
+      fft(spectrum, false);
+      for (int l = 0; l < WAVETABLE_LEVELS; ++l) {
+        // Keep DC and harmonics 1..H (and their mirrors)
+        const int harmonics = (WAVETABLE_SIZE / 2) >> l;
+        for (int k = 0; k < WAVETABLE_SIZE; ++k) {
+          int h = std::min(k, WAVETABLE_SIZE - k);
+          band[k] = h <= harmonics ? spectrum[k] : 0.0;
+        }
+        fft(band, true);
+        for (int n = 0; n < WAVETABLE_SIZE; ++n)
+          level[n] = band[n].real();
+        data_.resize(data_.size() + WAVETABLE_STRIDE);
+        storeCycle(data_.data() + data_.size() - WAVETABLE_STRIDE,
+                   level.data());
+      }
+    }
+    ++tables_;
+    return true;
+  }
+
+  /**
+   * @brief The tables built so far, as an in-memory set
+   */
+  WavetableSet view() const {
+    WavetableSet set;
+    set.data = data_.data();
+    set.tables = tables_;
+    set.frames = frames_;
+    return set;
+  }
+
+  int getTables() const { return tables_; }
+
+  /**
+   * @brief Write the bank file
+   * @param path Output path
+   * @param error Set to a message on failure
+   * @return true on success
+   */
+  bool write(const std::string &path, std::string &error) const {
+    if (tables_ == 0) {
+      error = "no tables to write";
+      return false;
+    }
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    if (!file) {
+      error = "cannot write " + path;
+      return false;
+    }
+    WavetableFileHeader header;
+    header.tables = static_cast<uint32_t>(tables_);
+    header.frames = static_cast<uint32_t>(frames_);
+    char block[WAVETABLE_FILE_DATA_OFFSET] = {};
+    std::memcpy(block, &header, sizeof(header));
+    file.write(block, sizeof(block));
+    file.write(reinterpret_cast<const char *>(data_.data()),
+               static_cast<std::streamsize>(data_.size() * sizeof(float)));
+    if (!file) {
+      error = "write failed: " + path;
+      return false;
+    }
+    return true;
+  }
+
+private:
+  int frames_;
+  int tables_ = 0;
+  std::vector<float> data_;
+
+  // In-place radix-2 FFT; the inverse includes the 1/N scale
+  static void fft(std::vector<std::complex<double>> &x, bool inverse) {
+    const size_t n = x.size();
+    for (size_t i = 1, j = 0; i < n; ++i) {
+      size_t bit = n >> 1;
+      for (; j & bit; bit >>= 1)
+        j ^= bit;
+      j ^= bit;
+      if (i < j)
+        std::swap(x[i], x[j]);
+    }
+    for (size_t len = 2; len <= n; len <<= 1) {
+      const double angle = (inverse ? TWO_PI : -TWO_PI) / len;
+      const std::complex<double> step(std::cos(angle), std::sin(angle));
+      for (size_t i = 0; i < n; i += len) {
+        std::complex<double> w(1.0, 0.0);
+        for (size_t k = 0; k < len / 2; ++k) {
+          std::complex<double> even = x[i + k];
+          std::complex<double> odd = x[i + k + len / 2] * w;
+          x[i + k] = even + odd;
+          x[i + k + len / 2] = even - odd;
+          w *= step;
+        }
+      }
+    }
+    if (inverse)
+      for (auto &v : x)
+        v /= static_cast<double>(n);
+  }
+};
+
+} // namespace synth
@@ -10,29 +10,56 @@
  * - Full ADSR envelope control
  * - Preset system with drum sounds
  * - Low-pass filter with cutoff and resonance
+ *
+ * Usage:
+ *   minilogue_synth [RATE] [--rate HZ] [--period FRAMES] [--backend NAME]
+ *                   [--voices N] [--steal oldest|quietest|released]
+ *                   [--headless SECONDS]
+ *
+ * --backend picks a miniaudio backend (alsa, pulseaudio, jack, null, ...).
+ * --headless skips the keyboard UI, holds a full chord for the given time
+ * and reports audio callback load; with --backend null it needs no sound
+ * card at all.
  */
 
 // C++ standard library headers MUST come before miniaudio
 // to avoid std::char_traits conflicts with older GCC versions
-#include <conio.h>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <csignal>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
 #include <iomanip>
 #include <iostream>
-#include <windows.h>
+#include <string>
 
 #include "core/presets.hpp"
 #include "engine/synth_engine.hpp"
+#include "platform/console.hpp"
 
 #define MINIAUDIO_IMPLEMENTATION
 #include "../include/miniaudio.h"
 
 using namespace synth;
 
-// Global synth engine
+// Global synth engine (owned by the audio thread once the device starts;
+// the UI talks to it only through the command queue)
 SynthEngine g_synth;
-bool g_running = true;
+volatile std::sig_atomic_t g_running = 1;
+int g_preset = 0;
+unsigned g_sampleRate = 192000;
 int g_octave = 4;
 int g_lastNote = -1;
-DWORD g_noteOnTime = 0;
+uint32_t g_noteOnTime = 0;
+
+// Audio callback timing, written by the audio thread only
+std::atomic<uint64_t> g_callbackCount{0};
+std::atomic<uint64_t> g_callbackFrames{0};
+std::atomic<uint64_t> g_callbackNanos{0};
+std::atomic<uint64_t> g_callbackMaxNanos{0};
 
 // Current parameter values for display
 double g_attack = 0.01;
@@ -49,6 +76,11 @@ double g_sawMix = 1.0;
 double g_sqrMix = 0.0;
 double g_noiseMix = 0.0;
 
+// Effects bypass state (all off, matching the engine default)
+bool g_chorusOn = false;
+bool g_delayOn = false;
+bool g_reverbOn = false;
+
 // Keyboard to MIDI note mapping (QWERTY layout)
 int keyToNote(char key) {
   int base = 12 * g_octave;
@@ -95,33 +127,59 @@ int keyToNote(char key) {
 // Audio callback
 void audioCallback(ma_device *pDevice, void *pOutput, const void *pInput,
                    ma_uint32 frameCount) {
+  auto start = std::chrono::steady_clock::now();
+  const ma_uint32 totalFrames = frameCount;
   float *output = static_cast<float *>(pOutput);
-
-  for (ma_uint32 i = 0; i < frameCount; ++i) {
-    Sample left, right;
-    g_synth.processStereo(left, right);
-    output[i * 2 + 0] = static_cast<float>(left);
-    output[i * 2 + 1] = static_cast<float>(right);
+  float left[MAX_BLOCK_SIZE];
+  float right[MAX_BLOCK_SIZE];
+
+  while (frameCount > 0) {
+    ma_uint32 n = std::min(frameCount, static_cast<ma_uint32>(MAX_BLOCK_SIZE));
+    g_synth.processBlock(left, right, n);
+    for (ma_uint32 i = 0; i < n; ++i) {
+      output[i * 2 + 0] = left[i];
+      output[i * 2 + 1] = right[i];
+    }
+    output += n * 2;
+    frameCount -= n;
   }
 
+  uint64_t nanos = static_cast<uint64_t>(
+      std::chrono::duration_cast<std::chrono::nanoseconds>(
+          std::chrono::steady_clock::now() - start)
+          .count());
+  g_callbackCount.fetch_add(1, std::memory_order_relaxed);
+  g_callbackFrames.fetch_add(totalFrames, std::memory_order_relaxed);
+  g_callbackNanos.fetch_add(nanos, std::memory_order_relaxed);
+  if (nanos > g_callbackMaxNanos.load(std::memory_order_relaxed))
+    g_callbackMaxNanos.store(nanos, std::memory_order_relaxed);
+
   (void)pDevice;
   (void)pInput;
 }
 
-void clearScreen() { system("cls"); }
+// Queue a command for the audio thread (dropped only if the queue is full)
+void sendCommand(const EngineCommand &cmd) { g_synth.postCommand(cmd); }
+
+void sendParameter(EngineCommand::Type type, double value) {
+  sendCommand(EngineCommand::setParameter(type, value));
+}
+
+void onSignal(int) { g_running = 0; }
 
 void printUI() {
-  clearScreen();
+  Console::clearScreen();
   std::cout << "\n";
   std::cout << "==============================================================="
                "=================\n";
   std::cout << "                    FPGA SYNTH - Korg Minilogue XD Clone\n";
-  std::cout << "                           24-bit / 192 kHz\n";
+  std::cout << "                           24-bit / " << g_sampleRate / 1000
+            << " kHz\n";
   std::cout << "==============================================================="
                "=================\n\n";
 
-  std::cout << "  PRESET: " << g_synth.getCurrentPresetName() << " ["
-            << g_synth.getCurrentPreset() << "]\n\n";
+  std::cout << "  PRESET: " << PresetBank::getPresetName(g_preset) << " ["
+            << g_preset << "]\n\n";
 
   std::cout << "  .------------------.    .------------------.\n";
   std::cout << "  |  WAVE MIX        |    |  FILTER          |\n";
@@ -182,6 +240,10 @@ void printUI() {
       << "  |            (Shift + 1-8)                                |\n";
   std::cout
       << "  |                                                         |\n";
+  std::cout
+      << "  |  EFFECTS:  C/V/B = Toggle Chorus/Delay/Reverb           |\n";
+  std::cout
+      << "  |                                                         |\n";
   std::cout
       << "  |  OCTAVE:   Z/X = Down/Up       SPACE = All notes off    |\n";
   std::cout
@@ -196,39 +258,201 @@ void updateDisplay(const char *message) {
 }
 
 void updateWaveMix() {
-  g_synth.setWaveMix(g_sineMix, g_triMix, g_sawMix, g_sqrMix, g_noiseMix);
+  WaveMix mix;
+  mix.sine = g_sineMix;
+  mix.triangle = g_triMix;
+  mix.sawtooth = g_sawMix;
+  mix.square = g_sqrMix;
+  mix.noise = g_noiseMix;
+  sendCommand(EngineCommand::setWaveMix(mix));
 }
 
-int main() {
-  std::cout << "Initializing audio at 192kHz...\n";
+// Command-line options for the real-time front end
+struct Options {
+  ma_uint32 sampleRate = 192000;
+  ma_uint32 periodFrames = 512;
+  std::string backend; // Empty: miniaudio's default priority list
+  int voices = NUM_VOICES;
+  StealPolicy steal = StealPolicy::RELEASED_FIRST;
+  double headlessSeconds = 0.0;
+};
+
+void printUsage() {
+  std::cerr << "Usage: minilogue_synth [RATE] [--rate HZ] [--period FRAMES]\n"
+               "                       [--backend NAME] [--voices N]\n"
+               "                       [--steal oldest|quietest|released]\n"
+               "                       [--headless SECONDS]\n"
+               "Backends: wasapi dsound winmm coreaudio alsa pulseaudio jack "
+               "null\n";
+}
+
+bool parseOptions(int argc, char **argv, Options &opts) {
+  int i = 1;
+  // Legacy form: bare sample rate as the first argument
+  if (argc > 1 && std::atoi(argv[1]) > 0) {
+    opts.sampleRate = static_cast<ma_uint32>(std::atoi(argv[1]));
+    i = 2;
+  }
+  for (; i < argc; i += 2) {
+    if (i + 1 >= argc)
+      return false;
+    if (std::strcmp(argv[i], "--rate") == 0) {
+      opts.sampleRate = static_cast<ma_uint32>(std::atoi(argv[i + 1]));
+    } else if (std::strcmp(argv[i], "--period") == 0) {
+      opts.periodFrames = static_cast<ma_uint32>(std::atoi(argv[i + 1]));
+    } else if (std::strcmp(argv[i], "--backend") == 0) {
+      opts.backend = argv[i + 1];
+    } else if (std::strcmp(argv[i], "--voices") == 0) {
+      opts.voices = std::atoi(argv[i + 1]);
+    } else if (std::strcmp(argv[i], "--steal") == 0) {
+      if (!stealPolicyFromName(argv[i + 1], opts.steal))
+        return false;
+    } else if (std::strcmp(argv[i], "--headless") == 0) {
+      opts.headlessSeconds = std::atof(argv[i + 1]);
+    } else {
+      return false;
+    }
+  }
+  return opts.sampleRate > 0 && opts.periodFrames > 0 &&
+         opts.voices >= 1 && opts.voices <= MAX_POLYPHONY &&
+         opts.headlessSeconds >= 0.0;
+}
+
+bool findBackend(const std::string &name, ma_backend &backend) {
+  static const struct {
+    const char *name;
+    ma_backend backend;
+  } table[] = {{"wasapi", ma_backend_wasapi},
+               {"dsound", ma_backend_dsound},
+               {"winmm", ma_backend_winmm},
+               {"coreaudio", ma_backend_coreaudio},
+               {"alsa", ma_backend_alsa},
+               {"pulseaudio", ma_backend_pulseaudio},
+               {"pulse", ma_backend_pulseaudio},
+               {"jack", ma_backend_jack},
+               {"null", ma_backend_null}};
+  for (const auto &entry : table) {
+    if (name == entry.name) {
+      backend = entry.backend;
+      return true;
+    }
+  }
+  return false;
+}
+
+/**
+ * @brief Print average/peak callback cost relative to the period deadline
+ */
+void printLoadReport(ma_uint32 sampleRate) {
+  uint64_t count = g_callbackCount.load();
+  uint64_t frames = g_callbackFrames.load();
+  if (count == 0 || frames == 0) {
+    std::cout << "No audio callbacks were received.\n";
+    return;
+  }
+  double busy = g_callbackNanos.load() * 1e-9;
+  double audio = static_cast<double>(frames) / sampleRate;
+  double avgFrames = static_cast<double>(frames) / count;
+  double peakLoad = g_callbackMaxNanos.load() * 1e-9 / (avgFrames / sampleRate);
+  std::cout << std::fixed << std::setprecision(1) << "Callbacks: " << count
+            << " (" << avgFrames << " frames avg), audio " << audio
+            << " s\n"
+            << "DSP load: " << std::setprecision(2) << 100.0 * busy / audio
+            << "% avg, " << 100.0 * peakLoad << "% peak of period\n";
+}
+
+/**
+ * @brief Headless load test: hold every voice and let the device run
+ */
+void runHeadless(double seconds) {
+  const int chord[] = {48, 55, 60, 64, 67, 72, 76, 79};
+  sendCommand(EngineCommand::loadPreset(g_preset));
+  for (int v = 0; v < g_synth.getPolyphony(); ++v)
+    sendCommand(EngineCommand::noteOn(chord[v % 8], 0.8));
+
+  const uint32_t start = Console::milliseconds();
+  const uint32_t durationMs = static_cast<uint32_t>(seconds * 1000.0);
+  while (g_running && Console::milliseconds() - start < durationMs)
+    Console::sleepMs(10);
+}
+
+int main(int argc, char **argv) {
+  Options opts;
+  if (!parseOptions(argc, argv, opts)) {
+    printUsage();
+    return 1;
+  }
+
+  std::signal(SIGINT, onSignal);
+  std::signal(SIGTERM, onSignal);
+
+  ma_context context;
+  ma_backend backend;
+  if (!opts.backend.empty()) {
+    if (!findBackend(opts.backend, backend)) {
+      std::cerr << "Unknown backend: " << opts.backend << "\n";
+      printUsage();
+      return 1;
+    }
+  }
+  if (ma_context_init(opts.backend.empty() ? NULL : &backend,
+                      opts.backend.empty() ? 0 : 1, NULL,
+                      &context) != MA_SUCCESS) {
+    std::cerr << "Audio backend unavailable: "
+              << (opts.backend.empty() ? "default" : opts.backend) << "\n";
+    return -1;
+  }
+
+  std::cout << "Initializing audio at " << opts.sampleRate << " Hz ("
+            << ma_get_backend_name(context.backend) << ", period "
+            << opts.periodFrames << " frames)...\n";
 
   ma_device_config config = ma_device_config_init(ma_device_type_playback);
   config.playback.format = ma_format_f32;
   config.playback.channels = 2;
-  config.sampleRate = 192000;
+  config.sampleRate = opts.sampleRate;
   config.dataCallback = audioCallback;
-  config.periodSizeInFrames = 512;
+  config.periodSizeInFrames = opts.periodFrames;
+  config.noPreSilencedOutputBuffer = MA_TRUE; // Callback writes every frame
 
   ma_device device;
-  if (ma_device_init(NULL, &config, &device) != MA_SUCCESS) {
-    std::cerr << "Failed at 192kHz, trying 48kHz...\n";
+  if (ma_device_init(&context, &config, &device) != MA_SUCCESS) {
+    std::cerr << "Failed at " << opts.sampleRate << " Hz, trying 48kHz...\n";
     config.sampleRate = 48000;
-    if (ma_device_init(NULL, &config, &device) != MA_SUCCESS) {
+    if (ma_device_init(&context, &config, &device) != MA_SUCCESS) {
       std::cerr << "Audio initialization failed!\n";
+      ma_context_uninit(&context);
       return -1;
     }
   }
 
   std::cout << "Audio initialized: " << device.sampleRate << " Hz\n";
 
+  // Size the voice pool, then tune every DSP module to the granted rate
+  g_synth.setPolyphony(opts.voices);
+  g_synth.setStealPolicy(opts.steal);
+  g_sampleRate = device.sampleRate;
+  g_synth.prepare(static_cast<double>(device.sampleRate));
+
   if (ma_device_start(&device) != MA_SUCCESS) {
     std::cerr << "Failed to start audio device!\n";
     ma_device_uninit(&device);
+    ma_context_uninit(&context);
     return -1;
   }
 
+  if (opts.headlessSeconds > 0.0) {
+    runHeadless(opts.headlessSeconds);
+    ma_device_uninit(&device);
+    ma_context_uninit(&context);
+    printLoadReport(g_sampleRate);
+    return 0;
+  }
+
+  Console console;
+
   // Load initial preset
-  g_synth.loadPreset(0);
+  sendCommand(EngineCommand::loadPreset(0));
 
   printUI();
 
@@ -236,23 +460,24 @@ int main() {
 
   while (g_running) {
     // Auto note-off after 300ms
-    if (g_lastNote >= 0 && (GetTickCount() - g_noteOnTime) > 300) {
-      g_synth.noteOff(g_lastNote);
+    if (g_lastNote >= 0 && (Console::milliseconds() - g_noteOnTime) > 300) {
+      sendCommand(EngineCommand::noteOff(g_lastNote));
       g_lastNote = -1;
     }
 
-    if (_kbhit()) {
-      char key = _getch();
+    int keyCode = console.readKey();
+    if (keyCode != Console::NO_KEY) {
+      char key = static_cast<char>(keyCode);
 
       // ESC to quit
-      if (key == 27) {
-        g_running = false;
+      if (keyCode == Console::KEY_ESCAPE) {
+        g_running = 0;
         break;
       }
 
       // Space = all notes off
       if (key == ' ') {
-        g_synth.allNotesOff();
+        sendCommand(EngineCommand::allNotesOff());
         g_lastNote = -1;
         updateDisplay("All notes OFF");
         continue;
@@ -260,10 +485,11 @@ int main() {
 
       // Preset selection (comma = previous, period = next)
       if (key == ',' || key == '<') {
-        int presetNum = g_synth.getCurrentPreset();
+        int presetNum = g_preset;
         presetNum =
             (presetNum > 0) ? presetNum - 1 : PresetBank::NUM_PRESETS - 1;
-        g_synth.loadPreset(presetNum);
+        g_preset = presetNum;
+        sendCommand(EngineCommand::loadPreset(presetNum));
         SynthPreset p = PresetBank::getPreset(presetNum);
         g_sineMix = p.waveMix.sine;
         g_triMix = p.waveMix.triangle;
@@ -282,10 +508,11 @@ int main() {
         continue;
       }
       if (key == '.' || key == '>') {
-        int presetNum = g_synth.getCurrentPreset();
+        int presetNum = g_preset;
         presetNum =
             (presetNum < PresetBank::NUM_PRESETS - 1) ? presetNum + 1 : 0;
-        g_synth.loadPreset(presetNum);
+        g_preset = presetNum;
+        sendCommand(EngineCommand::loadPreset(presetNum));
         SynthPreset p = PresetBank::getPreset(presetNum);
         g_sineMix = p.waveMix.sine;
         g_triMix = p.waveMix.triangle;
@@ -318,6 +545,26 @@ int main() {
         continue;
       }
 
+      // Effects bypass toggles
+      if (key == 'c' || key == 'C') {
+        g_chorusOn = !g_chorusOn;
+        sendParameter(EngineCommand::Type::SET_CHORUS_ENABLED, g_chorusOn);
+        updateDisplay(g_chorusOn ? "Chorus: ON" : "Chorus: OFF");
+        continue;
+      }
+      if (key == 'v' || key == 'V') {
+        g_delayOn = !g_delayOn;
+        sendParameter(EngineCommand::Type::SET_DELAY_ENABLED, g_delayOn);
+        updateDisplay(g_delayOn ? "Delay: ON" : "Delay: OFF");
+        continue;
+      }
+      if (key == 'b' || key == 'B') {
+        g_reverbOn = !g_reverbOn;
+        sendParameter(EngineCommand::Type::SET_REVERB_ENABLED, g_reverbOn);
+        updateDisplay(g_reverbOn ? "Reverb: ON" : "Reverb: OFF");
+        continue;
+      }
+
       // Wave mix toggles
       if (key == 'a' || key == 'A') {
         g_sineMix = (g_sineMix > 0.5) ? 0.0 : 1.0;
@@ -362,7 +609,7 @@ int main() {
       // Filter controls
       if (key == '[') {
         g_filterCutoff = (g_filterCutoff > 100) ? g_filterCutoff * 0.8 : 100;
-        g_synth.setFilterCutoff(g_filterCutoff);
+        sendParameter(EngineCommand::Type::SET_FILTER_CUTOFF, g_filterCutoff);
         snprintf(statusMsg, sizeof(statusMsg), "Cutoff: %d Hz",
                  (int)g_filterCutoff);
         updateDisplay(statusMsg);
@@ -371,7 +618,7 @@ int main() {
       if (key == ']') {
         g_filterCutoff =
             (g_filterCutoff < 15000) ? g_filterCutoff * 1.25 : 15000;
-        g_synth.setFilterCutoff(g_filterCutoff);
+        sendParameter(EngineCommand::Type::SET_FILTER_CUTOFF, g_filterCutoff);
         snprintf(statusMsg, sizeof(statusMsg), "Cutoff: %d Hz",
                  (int)g_filterCutoff);
         updateDisplay(statusMsg);
@@ -379,14 +626,16 @@ int main() {
       }
       if (key == '-') {
         g_filterRes = (g_filterRes > 0.1) ? g_filterRes - 0.1 : 0.0;
-        g_synth.setFilterResonance(g_filterRes);
+        sendParameter(EngineCommand::Type::SET_FILTER_RESONANCE,
+                      g_filterRes);
         snprintf(statusMsg, sizeof(statusMsg), "Resonance: %.1f", g_filterRes);
         updateDisplay(statusMsg);
         continue;
       }
       if (key == '=') {
         g_filterRes = (g_filterRes < 0.9) ? g_filterRes + 0.1 : 0.95;
-        g_synth.setFilterResonance(g_filterRes);
+        sendParameter(EngineCommand::Type::SET_FILTER_RESONANCE,
+                      g_filterRes);
         snprintf(statusMsg, sizeof(statusMsg), "Resonance: %.1f", g_filterRes);
         updateDisplay(statusMsg);
         continue;
@@ -396,7 +645,7 @@ int main() {
       // Attack: ! (Shift+1) and @ (Shift+2)
       if (key == '!') {
         g_attack = (g_attack > 0.01) ? g_attack * 0.7 : 0.001;
-        g_synth.setAmpAttack(g_attack);
+        sendParameter(EngineCommand::Type::SET_AMP_ATTACK, g_attack);
         snprintf(statusMsg, sizeof(statusMsg), "Attack: %d ms",
                  (int)(g_attack * 1000));
         updateDisplay(statusMsg);
@@ -404,7 +653,7 @@ int main() {
       }
       if (key == '@') {
         g_attack = (g_attack < 1.5) ? g_attack * 1.4 : 2.0;
-        g_synth.setAmpAttack(g_attack);
+        sendParameter(EngineCommand::Type::SET_AMP_ATTACK, g_attack);
         snprintf(statusMsg, sizeof(statusMsg), "Attack: %d ms",
                  (int)(g_attack * 1000));
         updateDisplay(statusMsg);
@@ -414,7 +663,7 @@ int main() {
       // Decay: # (Shift+3) and $ (Shift+4)
       if (key == '#') {
         g_decay = (g_decay > 0.01) ? g_decay * 0.7 : 0.001;
-        g_synth.setAmpDecay(g_decay);
+        sendParameter(EngineCommand::Type::SET_AMP_DECAY, g_decay);
         snprintf(statusMsg, sizeof(statusMsg), "Decay: %d ms",
                  (int)(g_decay * 1000));
         updateDisplay(statusMsg);
@@ -422,7 +671,7 @@ int main() {
       }
       if (key == '$') {
         g_decay = (g_decay < 1.5) ? g_decay * 1.4 : 2.0;
-        g_synth.setAmpDecay(g_decay);
+        sendParameter(EngineCommand::Type::SET_AMP_DECAY, g_decay);
         snprintf(statusMsg, sizeof(statusMsg), "Decay: %d ms",
                  (int)(g_decay * 1000));
         updateDisplay(statusMsg);
@@ -432,7 +681,7 @@ int main() {
       // Sustain: % (Shift+5) and ^ (Shift+6)
       if (key == '%') {
         g_sustain = (g_sustain > 0.1) ? g_sustain - 0.1 : 0.0;
-        g_synth.setAmpSustain(g_sustain);
+        sendParameter(EngineCommand::Type::SET_AMP_SUSTAIN, g_sustain);
         snprintf(statusMsg, sizeof(statusMsg), "Sustain: %d%%",
                  (int)(g_sustain * 100));
         updateDisplay(statusMsg);
@@ -440,7 +689,7 @@ int main() {
       }
       if (key == '^') {
         g_sustain = (g_sustain < 0.9) ? g_sustain + 0.1 : 1.0;
-        g_synth.setAmpSustain(g_sustain);
+        sendParameter(EngineCommand::Type::SET_AMP_SUSTAIN, g_sustain);
         snprintf(statusMsg, sizeof(statusMsg), "Sustain: %d%%",
                  (int)(g_sustain * 100));
         updateDisplay(statusMsg);
@@ -450,7 +699,7 @@ int main() {
       // Release: & (Shift+7) and * (Shift+8)
       if (key == '&') {
         g_release = (g_release > 0.05) ? g_release * 0.7 : 0.01;
-        g_synth.setAmpRelease(g_release);
+        sendParameter(EngineCommand::Type::SET_AMP_RELEASE, g_release);
         snprintf(statusMsg, sizeof(statusMsg), "Release: %d ms",
                  (int)(g_release * 1000));
         updateDisplay(statusMsg);
@@ -458,7 +707,7 @@ int main() {
       }
       if (key == '*') {
         g_release = (g_release < 2.5) ? g_release * 1.4 : 3.0;
-        g_synth.setAmpRelease(g_release);
+        sendParameter(EngineCommand::Type::SET_AMP_RELEASE, g_release);
         snprintf(statusMsg, sizeof(statusMsg), "Release: %d ms",
                  (int)(g_release * 1000));
         updateDisplay(statusMsg);
@@ -469,21 +718,23 @@ int main() {
       int note = keyToNote(key);
       if (note >= 0) {
         if (g_lastNote >= 0)
-          g_synth.noteOff(g_lastNote);
-        g_synth.noteOn(note, 0.8);
+          sendCommand(EngineCommand::noteOff(g_lastNote));
+        sendCommand(EngineCommand::noteOn(note, 0.8));
         g_lastNote = note;
-        g_noteOnTime = GetTickCount();
+        g_noteOnTime = Console::milliseconds();
         snprintf(statusMsg, sizeof(statusMsg), "Note: %d", note);
         updateDisplay(statusMsg);
       }
     }
 
-    Sleep(10);
+    Console::sleepMs(10);
   }
 
   std::cout << "\nShutting down...\n";
-  g_synth.allNotesOff();
+  sendCommand(EngineCommand::allNotesOff());
   ma_device_uninit(&device);
+  ma_context_uninit(&context);
 
+  printLoadReport(g_sampleRate);
   return 0;
 }
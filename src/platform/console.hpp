@@ -0,0 +1,145 @@
+#pragma once
+/**
+ * @file console.hpp
+ * @brief Minimal terminal and clock abstraction for the interactive UI
+ *
+ * Wraps the handful of console calls main.cpp needs (non-blocking key
+ * reads, screen clear, millisecond clock, sleep) so the same front end
+ * builds on Windows (conio) and POSIX (termios raw mode).
+ */
+
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <thread>
+
+#ifdef _WIN32
+#include <conio.h>
+#else
+#include <poll.h>
+#include <termios.h>
+#include <unistd.h>
+#endif
+
+namespace synth {
+
+/**
+ * @class Console
+ * @brief Raw, non-blocking keyboard input for the lifetime of the object
+ *
+ * On POSIX the terminal is switched to non-canonical, no-echo mode and
+ * restored on destruction. Signals (Ctrl+C) stay enabled. When stdin is
+ * not a terminal the console reports no keys, so the synth can run under
+ * a service manager or in a pipeline.
+ */
+class Console {
+public:
+  /** @brief Returned by readKey() when nothing usable was pressed */
+  static constexpr int NO_KEY = -1;
+  static constexpr int KEY_ESCAPE = 27;
+
+  Console() {
+#ifndef _WIN32
+    interactive_ = isatty(STDIN_FILENO) != 0;
+    if (interactive_ && tcgetattr(STDIN_FILENO, &saved_) == 0) {
+      termios raw = saved_;
+      raw.c_lflag &= ~static_cast<tcflag_t>(ICANON | ECHO);
+      raw.c_cc[VMIN] = 0;
+      raw.c_cc[VTIME] = 0;
+      rawMode_ = tcsetattr(STDIN_FILENO, TCSANOW, &raw) == 0;
+    }
+#endif
+  }
+
+  ~Console() {
+#ifndef _WIN32
+    if (rawMode_)
+      tcsetattr(STDIN_FILENO, TCSANOW, &saved_);
+#endif
+  }
+
+  Console(const Console &) = delete;
+  Console &operator=(const Console &) = delete;
+
+  /**
+   * @brief Read one key without blocking
+   * @return Character code, or NO_KEY if none is waiting
+   *
+   * Multi-byte escape sequences (arrow and function keys) are swallowed so
+   * that only a bare ESC press reports KEY_ESCAPE.
+   */
+  int readKey() {
+#ifdef _WIN32
+    if (!_kbhit())
+      return NO_KEY;
+    int key = _getch();
+    if (key == 0 || key == 0xE0) { // Extended key: discard the scan code
+      _getch();
+      return NO_KEY;
+    }
+    return key;
+#else
+    if (!interactive_ || !waitForInput(0))
+      return NO_KEY;
+    unsigned char c;
+    if (read(STDIN_FILENO, &c, 1) != 1)
+      return NO_KEY;
+    if (c == KEY_ESCAPE && waitForInput(10)) {
+      unsigned char discard[16];
+      while (waitForInput(0) &&
+             read(STDIN_FILENO, discard, sizeof(discard)) > 0) {
+      }
+      return NO_KEY;
+    }
+    return c;
+#endif
+  }
+
+  /** @brief True when key input is available at all */
+  bool isInteractive() const {
+#ifdef _WIN32
+    return true;
+#else
+    return interactive_;
+#endif
+  }
+
+  static void clearScreen() {
+#ifdef _WIN32
+    std::system("cls");
+#else
+    std::cout << "\033[2J\033[H" << std::flush;
+#endif
+  }
+
+  /** @brief Monotonic milliseconds (wraps like GetTickCount) */
+  static uint32_t milliseconds() {
+    using namespace std::chrono;
+    return static_cast<uint32_t>(
+        duration_cast<std::chrono::milliseconds>(
+            steady_clock::now().time_since_epoch())
+            .count());
+  }
+
+  static void sleepMs(int ms) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(ms));
+  }
+
+private:
+#ifndef _WIN32
+  static bool waitForInput(int timeoutMs) {
+    pollfd pfd;
+    pfd.fd = STDIN_FILENO;
+    pfd.events = POLLIN;
+    pfd.revents = 0;
+    return poll(&pfd, 1, timeoutMs) > 0 && (pfd.revents & POLLIN);
+  }
+
+  termios saved_{};
+  bool interactive_ = false;
+  bool rawMode_ = false;
+#endif
+};
+
+} // namespace synth
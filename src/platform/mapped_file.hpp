@@ -0,0 +1,122 @@
+#pragma once
+/**
+ * @file mapped_file.hpp
+ * @brief Read-only memory-mapped file (mmap / MapViewOfFile)
+ *
+ * Pages are loaded by the OS on first touch and shared between every
+ * mapping of the same file, so large read-only data costs physical memory
+ * once per machine, not once per object that reads it.
+ */
+
+#include <cstddef>
+#include <string>
+#include <utility>
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace synth {
+
+/**
+ * @class MappedFile
+ * @brief Owns one read-only view of a whole file; move-only
+ */
+class MappedFile {
+public:
+  MappedFile() = default;
+  ~MappedFile() { close(); }
+
+  MappedFile(const MappedFile &) = delete;
+  MappedFile &operator=(const MappedFile &) = delete;
+
+  MappedFile(MappedFile &&other) noexcept { swap(other); }
+  MappedFile &operator=(MappedFile &&other) noexcept {
+    if (this != &other) {
+      close();
+      swap(other);
+    }
+    return *this;
+  }
+
+  /**
+   * @brief Map a file read-only (replaces any current mapping)
+   * @param path File to map
+   * @return true on success; an empty file fails
+   */
+  bool open(const std::string &path) {
+    close();
+#ifdef _WIN32
+    HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ,
+                              NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+    if (file == INVALID_HANDLE_VALUE)
+      return false;
+    LARGE_INTEGER size;
+    HANDLE mapping = NULL;
+    if (GetFileSizeEx(file, &size) && size.QuadPart > 0)
+      mapping = CreateFileMappingA(file, NULL, PAGE_READONLY, 0, 0, NULL);
+    CloseHandle(file); // The mapping keeps its own reference
+    if (mapping == NULL)
+      return false;
+    void *view = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+    CloseHandle(mapping);
+    if (view == NULL)
+      return false;
+    data_ = view;
+    size_ = static_cast<size_t>(size.QuadPart);
+#else
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0)
+      return false;
+    struct stat st;
+    void *view = MAP_FAILED;
+    if (::fstat(fd, &st) == 0 && st.st_size > 0)
+      view = ::mmap(nullptr, static_cast<size_t>(st.st_size), PROT_READ,
+                    MAP_SHARED, fd, 0);
+    ::close(fd); // The mapping keeps its own reference
+    if (view == MAP_FAILED)
+      return false;
+    data_ = view;
+    size_ = static_cast<size_t>(st.st_size);
+#endif
+    return true;
+  }
+
+  /**
+   * @brief Unmap the file (safe to call when nothing is mapped)
+   */
+  void close() {
+    if (data_ == nullptr)
+      return;
+#ifdef _WIN32
+    UnmapViewOfFile(data_);
+#else
+    ::munmap(data_, size_);
+#endif
+    data_ = nullptr;
+    size_ = 0;
+  }
+
+  bool isOpen() const { return data_ != nullptr; }
+  const void *data() const { return data_; }
+  size_t size() const { return size_; }
+
+private:
+  void *data_ = nullptr;
+  size_t size_ = 0;
+
+  void swap(MappedFile &other) {
+    std::swap(data_, other.data_);
+    std::swap(size_, other.size_);
+  }
+};
+
+} // namespace synth